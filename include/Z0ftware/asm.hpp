@@ -24,12 +24,15 @@
 #define Z0FTWARE_ASM_HPP
 
 #include "Z0ftware/card.hpp"
+#include "Z0ftware/charset.hpp"
 #include "Z0ftware/exprs.hpp"
+#include "Z0ftware/op.hpp"
 #include "Z0ftware/operation.hpp"
 
 #include <functional>
-#include <map>
+#include <span>
 #include <utility>
+#include <vector>
 
 // Core corresponding to one operation
 class Chunk {
@@ -113,6 +116,8 @@ public:
 
   addr_t getLocation() const override;
   addr_t getSymbolValue(const std::string &string) override;
+  addr_t getSlotValue(const SymbolSlots &slots,
+                      SymbolSlots::slot_t slot) override;
 
 private:
   Assembler &assembler_;
@@ -129,16 +134,16 @@ public:
   virtual std::pair<std::string_view, std::string_view>
   splitVariableAndComment(const std::string_view &variableandComment) const;
 
-  auto operator[](const std::string_view &symbol) {
-    return symbolValues_[{symbol.begin(), symbol.end()}];
-  }
+  // The value of symbol, defined as 0 if undefined. The reference is only
+  // valid until the next symbol is added, since the values may then move.
+  FixPoint &operator[](const std::string_view &symbol);
   // If symbol is not empty, associate it with value
-  void defineSymbol(const std::string_view &symbol, FixPoint value) {
-    if (!symbol.empty()) {
-      symbolValues_.emplace(std::string{symbol.begin(), symbol.end()}, value);
-    }
-  }
-  [[nodiscard]] addr_t getSymbolValue(const std::string &symbol);
+  void defineSymbol(const std::string_view &symbol, FixPoint value);
+  [[nodiscard]] addr_t getSymbolValue(const std::string_view &symbol);
+  [[nodiscard]] addr_t getSymbolValue(SymbolSlots::slot_t slot);
+
+  // Slots for the symbols of compiled expressions
+  SymbolSlots &getSymbolSlots() { return symbolSlots_; }
 
   addr_t evaluate(const Chunk &chunk, const Expr &expr);
   addr_t evaluate(const Expr &expr);
@@ -179,12 +184,20 @@ public:
 
   void writeBinarySection(const Section &section);
 
-  const std::map<std::string, FixPoint> &getSymbolValues() const {
-    return symbolValues_;
-  }
+  // The defined symbols and their values, sorted by name, for listings
+  std::vector<std::pair<std::string_view, FixPoint>>
+  getSortedSymbolValues() const;
+
+  // Charset for the text of BCD pseudo-ops
+  const BCDCharSet &getCharSet() const { return *charSet_; }
+  void setCharSet(const BCDCharSet &charSet) { charSet_ = &charSet; }
+
+  // Parse expressions with PegEXPParser, the reference for EXPParser
+  bool getPegEXP() const { return pegEXP_; }
+  void setPegEXP(bool pegEXP) { pegEXP_ = pegEXP; }
 
   using OperationParser = std::function<std::unique_ptr<Operation>()>;
-  using OperationParsers = std::map<std::string_view, OperationParser>;
+  using OperationParsers = MnemonicTable<OperationParser>;
 
   virtual OperationParser getOperationParser(const std::string_view &operation);
 
@@ -201,15 +214,35 @@ public:
                                           const std::string_view &variable);
 
 private:
-  std::map<std::string, FixPoint> symbolValues_;
+  [[noreturn]] void undefinedSymbol(const std::string_view &symbol);
+
+  SymbolSlots symbolSlots_;
+  // Defined values by slot
+  std::vector<std::optional<FixPoint>> slotValues_;
   std::vector<Section> sections_;
   std::optional<addr_t> defineLocation_;
   section_writer_t sectionWriter_;
   BinaryFormat binaryFormat_{BinaryFormat::Absolute};
+  const BCDCharSet *charSet_{&BCDSherman};
+  bool pegEXP_{false};
 
   static OperationParsers operationParsers_;
 };
 
+// The fields of every card of a deck, one vector per field, so each later
+// phase can run over a whole field at a time. The location symbol is trimmed.
+// The split of the variable from the comment depends on the operation, so it
+// is left to the operation.
+struct SAPDeckFields {
+  std::vector<std::string_view> lines;
+  std::vector<std::string_view> locationSymbols;
+  std::vector<std::string_view> operations;
+  std::vector<std::string_view> variablesAndComments;
+  std::vector<std::string_view> sequences;
+
+  size_t size() const { return lines.size(); }
+};
+
 class SAPAssembler : public Assembler {
 public:
   static constexpr CardTextField field80{cardColumnFirst, cardColumnLast};
@@ -217,9 +250,17 @@ public:
   static constexpr CardTextField fieldLocationSymbol{1, 6};
   static constexpr CardTextField fieldOperation{8, 3};
   static constexpr CardTextField fieldVariableAndComment{12, 60};
+  static constexpr CardTextField fieldSequence{73, 8};
 
   virtual std::unique_ptr<Operation>
   parseLine(const std::string_view &line) override;
+
+  // Cut every line into its fields in one pass
+  static SAPDeckFields extractFields(std::span<const std::string_view> lines);
+
+  // Same as parseLine on fields.lines[pos]
+  std::unique_ptr<Operation> parseCard(const SAPDeckFields &fields,
+                                       size_t pos);
 };
 
 #endif
@@ -72,6 +72,9 @@
 
 #include <Z0ftware/field.hpp>
 #include <Z0ftware/unicode.hpp>
+#include <Z0ftware/word.hpp>
+
+#include <span>
 
 // BCD values are 6 bits, but values are transformed between tape (which also
 // includes a 7th even parity bit) and scientific CPUs to make BCD order
@@ -121,4 +124,21 @@ public:
   }
 };
 
+// Six BCD characters per word, big-endian
+static constexpr size_t bcdPerWord{6};
+
+/**
+ * @brief Packs characters six to a word, big-endian. A partial last word is
+ * filled with pad.
+ * @returns The number of words written, limited by words.size().
+ */
+size_t packBCD(std::span<const bcd_t> bcds, std::span<word_t> words,
+               bcd_t pad = 060);
+
+/**
+ * @brief Unpacks six characters from each word, big-endian.
+ * @returns The number of characters written, limited by bcds.size().
+ */
+size_t unpackBCD(std::span<const word_t> words, std::span<bcd_t> bcds);
+
 #endif
@@ -28,7 +28,10 @@
 #include "Z0ftware/word.hpp"
 
 #include <array>
+#include <iosfwd>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 constexpr unsigned numCardColumns = 80;
@@ -37,6 +40,8 @@ constexpr unsigned cardColumnLast = 80;
 
 constexpr unsigned numCardRows = 12;
 
+class NamedCharset;
+
 using CardTextField = TextField<cardColumnFirst, cardColumnLast>;
 
 class card_row_t : public UnsignedImp<card_row_t, numCardColumns> {
@@ -64,15 +69,66 @@ public:
   //      23 (12:37-72)
   word_t getWord(int position) const;
   void setWord(int position, word_t value);
+
+  // All 24 words in getWord() order, converted together by bit transposes
+  using words_t = std::array<word_t, 24>;
+  words_t getWords() const;
+  // Columns 73-80 are unchanged
+  void setWords(const words_t &words);
+
   void clear() { data_.fill(0); }
 
 private:
   data_t data_{0};
 };
 
+constexpr size_t cbnCardSize = 2 * numCardColumns;
+
 CardImage readCBN(std::istream &input);
 void writeCBN(std::ostream &output, const CardImage &cardImage);
 
+// Decode the cbnCardSize chars of a CBN card
+void decodeCBN(const char *data, CardImage::data_t &columns);
+// Encode a card as cbnCardSize chars
+void encodeCBN(const CardImage &cardImage, char *data);
+
+// Encodes cards into a buffer that is written to output when full, so a deck
+// takes a few large writes rather than one per card
+class CardDeckWriter {
+public:
+  CardDeckWriter(std::ostream &output, size_t bufferCards = 1024);
+  CardDeckWriter(const CardDeckWriter &) = delete;
+  CardDeckWriter &operator=(const CardDeckWriter &) = delete;
+  ~CardDeckWriter() { flush(); }
+
+  void write(const CardImage &cardImage);
+  void flush();
+
+private:
+  std::ostream &output_;
+  std::vector<char> buffer_;
+  size_t size_{0};
+};
+
+// The cards of a CBN deck, read with one read and decoded together
+class CardDeck {
+public:
+  CardDeck() = default;
+  // Reads the rest of input. A short last card is padded with zeros.
+  CardDeck(std::istream &input);
+  CardDeck(const std::string &fileName);
+
+  // Replace the cards with those in data
+  void decode(std::span<const char> data);
+
+  const std::vector<CardImage> &getCards() const { return cards_; }
+  size_t size() const { return cards_.size(); }
+  const CardImage &operator[](size_t pos) const { return cards_[pos]; }
+
+private:
+  std::vector<CardImage> cards_;
+};
+
 class BinaryRowCard;
 class BinaryColumnCard {
   friend BinaryRowCard;
@@ -105,12 +161,13 @@ public:
   using column_num_t = int;
   using row_num_t = int;
 
+  BinaryRowCard() = default;
   BinaryRowCard(const BinaryColumnCard &card) { fill(card); }
 
   const auto &getRowWords() const { return rowWords_; }
   auto &getRowWords() { return rowWords_; }
 
-  BinaryRowCard &operator=(BinaryColumnCard &card) {
+  BinaryRowCard &operator=(const BinaryColumnCard &card) {
     fill(card);
     return *this;
   }
@@ -122,21 +179,56 @@ private:
   std::array<std::array<word_t, 12>, 3> rowWords_{{0}};
 };
 
+// The lines of a SAP source file. The text is read into one buffer and each
+// card is a view of a line in it, without the newline.
 class SAPDeck {
 public:
   SAPDeck(std::istream &stream);
+  // The cards of a source deck, decoded with decodeSourceCards
+  SAPDeck(const CardDeck &deck, const NamedCharset &charset);
   SAPDeck() = default;
+  // Cards point into text_, which moves with the deck but is not copied
+  SAPDeck(const SAPDeck &) = delete;
+  SAPDeck &operator=(const SAPDeck &) = delete;
+  SAPDeck(SAPDeck &&) = default;
+  SAPDeck &operator=(SAPDeck &&) = default;
 
   std::ostream &operator<<(std::ostream &os) const;
 
-  const std::vector<std::string> &getCards() const { return cards_; }
+  const std::vector<std::string_view> &getCards() const { return cards_; }
+
+  // Columns of source cards that had no one-byte glyph
+  size_t getNumSubstituted() const { return numSubstituted_; }
 
 private:
-  std::vector<std::string> cards_;
+  // Sets cards_ to the lines of text_
+  void splitLines();
+
+  std::vector<char> text_;
+  std::vector<std::string_view> cards_;
+  size_t numSubstituted_{0};
 };
 
 inline std::ostream &operator<<(std::ostream &os, const SAPDeck &deck) {
   return deck.operator<<(os);
 }
 
+// Stands in for a column whose glyph is unassigned or more than one byte
+constexpr char sourceCardSubstitute = '~';
+
+// Appends a line to text for each source card. Columns are converted to tape
+// BCD and then to the charset's glyphs, one byte per column, and trailing blank
+// columns are dropped.
+// Returns the number of columns replaced with sourceCardSubstitute.
+size_t decodeSourceCards(std::span<const CardImage> cards,
+                         const NamedCharset &charset, std::vector<char> &text);
+
+// Appends a source card for each line, the inverse of decodeSourceCards. Chars
+// past column 80 are dropped, and chars the charset cannot encode are punched
+// as tape BCD 077.
+// Returns the number of chars the charset could not encode.
+size_t encodeSourceCards(std::span<const std::string_view> lines,
+                         const NamedCharset &charset,
+                         std::vector<CardImage> &cards);
+
 #endif
@@ -27,10 +27,19 @@
 #include "Z0ftware/hollerith.hpp"
 #include "Z0ftware/parity.hpp"
 #include "Z0ftware/unicode.hpp"
+#include "Z0ftware/utils.hpp"
 
 #include <array>
+#include <deque>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
 
 /**
  * @brief Information about the UTF8 to use for a BCD or Hollerith character. In
@@ -41,31 +50,48 @@
 class Glyph {
 
 public:
-  template <typename T>
-  Glyph(T c, bool canonic = true)
-      : utf8_(get_utf8_char(c)), canonic_(canonic) {}
+  Glyph(unicode_char_t c, bool canonic = true)
+      : size_(encodeUtf8(c, utf8_.data())), canonic_(canonic) {}
 
-  Glyph() : utf8_(utf8_replacement), canonic_(false) {}
+  Glyph(utf8_string_view_t utf8, bool canonic = true)
+      : Glyph(get_unicode_char(utf8), canonic) {}
 
-  operator unicode_char_t() const { return get_unicode_char(utf8_); }
+  Glyph(const char *utf8, bool canonic = true)
+      : Glyph(utf8_string_view_t(utf8), canonic) {}
+
+  Glyph(const utf8_t &utf8, bool canonic = true)
+      : Glyph(utf8_string_view_t(utf8), canonic) {}
+
+  Glyph() : Glyph(unicode_replacement_char, false) {}
+
+  operator unicode_char_t() const { return getUnicodeChar(); }
 
   /**
    * @brief Print using utf-8.
    */
   friend inline std::ostream &operator<<(std::ostream &s, const Glyph &cs) {
-    return s << cs.utf8_;
+    return s << cs.getUtf8View();
   }
 
-  unicode_char_t getUnicodeChar() const { return get_unicode_char(utf8_); }
+  unicode_char_t getUnicodeChar() const {
+    unicode_char_t c;
+    decodeUtf8(getUtf8View(), c);
+    return c;
+  }
 
-  utf8_t getUtf8Char() const { return utf8_; }
+  utf8_t getUtf8Char() const { return utf8_t(getUtf8View()); }
+
+  utf8_string_view_t getUtf8View() const {
+    return utf8_string_view_t(utf8_.data(), size_);
+  }
 
   bool isCanonic() const { return canonic_; }
 
-  bool isValid() const { return utf8_ != utf8_replacement; }
+  bool isValid() const { return getUtf8View() != utf8_replacement; }
 
 protected:
-  utf8_t utf8_;
+  std::array<char, utf8_max_size> utf8_;
+  uint8_t size_;
   bool canonic_;
 };
 
@@ -114,6 +140,28 @@ public:
 
 using parity_glyphs_t = GlyphsImp<parity_bcd_t>;
 
+// Flat form of a parity_glyphs_t for writing tape frames as UTF-8. Glyphs of
+// up to four bytes are in a fixed slot that is always copied whole; longer
+// ones, such as the parity error groups, are in a separate pool.
+class GlyphTranscoder {
+public:
+  GlyphTranscoder(const parity_glyphs_t &glyphs);
+
+  // Appends the glyphs for frames to output. Bit 7 of a frame is ignored.
+  void transcode(std::span<const char> frames, std::string &output) const;
+
+private:
+  static constexpr size_t slotSize = 4;
+  struct Entry {
+    std::array<char, slotSize> slot;
+    uint8_t size;
+    uint16_t poolPos;
+  };
+  std::array<Entry, 128> entries_;
+  std::string pool_;
+  size_t maxSize_{slotSize};
+};
+
 class CharsetForTape {
 public:
   virtual ~CharsetForTape() = default;
@@ -154,7 +202,6 @@ class IBM704BCDCharSet;
 class BCDCharSet {
 public:
   using charmap_t = std::array<utf8_t, 64>;
-  using utf8_map_t = std::unordered_map<utf8_t, bcd_t>;
 
   BCDCharSet(std::string &&description,
              const std::initializer_list<Glyph> &glyphs0,
@@ -163,11 +210,13 @@ public:
              const std::initializer_list<Glyph> &glyphs3)
       : description_(std::move(description)) {
     bcd_t bcd = 0;
-    auto add_glyphs = [&bcd, this](const std::initializer_list<Glyph> &glyphs) {
+    std::vector<WideEntry> wide;
+    auto add_glyphs = [&bcd, &wide,
+                       this](const std::initializer_list<Glyph> &glyphs) {
       for (auto &glyph : glyphs) {
         charMap_[bcd.value()] = glyph.getUtf8Char();
         if (glyph.isCanonic()) {
-          utf8_map_[glyph.getUtf8Char()] = bcd_t(bcd);
+          addCanonic(glyph.getUnicodeChar(), bcd, wide);
         }
         bcd++;
       };
@@ -176,6 +225,20 @@ public:
     add_glyphs(glyphs1);
     add_glyphs(glyphs2);
     add_glyphs(glyphs3);
+    hashWide(wide);
+  }
+
+  // Every valid glyph is canonic
+  BCDCharSet(const std::string &description, const charmap_t &glyphs)
+      : description_(description), charMap_(glyphs) {
+    std::vector<WideEntry> wide;
+    for (size_t i = 0; i < charMap_.size(); ++i) {
+      unicode_char_t c = get_unicode_char(charMap_[i]);
+      if (c != unicode_replacement_char) {
+        addCanonic(c, bcd_t(i), wide);
+      }
+    }
+    hashWide(wide);
   }
 
   BCDCharSet(const std::string &description) : description_() {}
@@ -191,18 +254,58 @@ public:
   const std::string &getDescription() const { return description_; }
 
   bcd_t getCPUBCD(const utf8_string_view_t &sv) const {
-    return getCPUBCD(utf8_t(sv));
+    unicode_char_t c;
+    return decodeUtf8(sv, c) == sv.size() ? getCPUBCD(c) : bcd_t(unknownBCD);
   }
 
-  bcd_t getCPUBCD(const utf8_t &c) const {
-    auto it = utf8_map_.find(c);
-    return it == utf8_map_.end() ? bcd_t(0x7f) : it->second;
+  bcd_t getCPUBCD(unicode_char_t c) const {
+    return c < asciiBCD_.size() ? bcd_t(asciiBCD_[c]) : getWideBCD(c);
   }
 
+  /**
+   * @brief Encodes utf-8 text as CPU BCD, one bcd_t per char, until either
+   * text or bcds runs out. Chars not in the charset are 077.
+   * @returns The number of bcd_t written.
+   */
+  size_t encode(utf8_string_view_t text, std::span<bcd_t> bcds) const;
+
 protected:
+  static constexpr uint8_t unknownBCD{077};
+
+  // A canonic glyph past ASCII, in the perfect hash table
+  struct WideEntry {
+    unicode_char_t unicode{0};
+    uint8_t bcd{unknownBCD};
+  };
+
+  void addCanonic(unicode_char_t c, bcd_t bcd, std::vector<WideEntry> &wide) {
+    if (c < asciiBCD_.size()) {
+      asciiBCD_[c] = bcd.value();
+    } else {
+      wide.push_back({c, uint8_t(bcd.value())});
+    }
+  }
+
+  // Builds a collision-free wideBCD_ for the entries. For duplicates, the last
+  // entry is used.
+  void hashWide(const std::vector<WideEntry> &wide);
+
+  bcd_t getWideBCD(unicode_char_t c) const {
+    auto &entry = wideBCD_[wideHash_(c)];
+    return bcd_t(entry.unicode == c ? entry.bcd : unknownBCD);
+  }
+
+  static constexpr std::array<uint8_t, 128> unknownASCII() {
+    std::array<uint8_t, 128> result;
+    result.fill(unknownBCD);
+    return result;
+  }
+
   std::string description_;
   charmap_t charMap_{};
-  utf8_map_t utf8_map_;
+  std::array<uint8_t, 128> asciiBCD_{unknownASCII()};
+  std::vector<WideEntry> wideBCD_{2};
+  MultiplicativeHash wideHash_;
 };
 
 class TapeBCDCharSet : public BCDCharSet {
@@ -249,6 +352,36 @@ extern const TapeBCDCharSet BCDICFinal_B;
 
 uint64_t bcd(utf8_string_view_t chars);
 
+// Tape glyphs for a BCDCharSet, with the same parity error groups as
+// CollateGlyphCardTape. There are no alternate glyphs.
+class BCDCharSetForTape : public CharsetForTape {
+public:
+  BCDCharSetForTape(const BCDCharSet &charSet) : charSet_(charSet) {}
+
+  std::unique_ptr<parity_glyphs_t>
+  getTapeCharset(bool alternate) const override;
+
+protected:
+  const BCDCharSet &charSet_;
+};
+
+// Frame counts by tape BCD value, parity ignored
+using bcd_histogram_t = std::array<uint64_t, 64>;
+
+// Adds the frames to the histogram.
+void addToHistogram(bcd_histogram_t &histogram, std::span<const char> frames);
+
+// How plausible the glyphs make text with this histogram; higher is better.
+// Each glyph has a weight: highest for blank, positive for letters, digits and
+// punctuation common in programs, and negative for other ASCII, glyphs outside
+// ASCII and glyphs that are not valid.
+int64_t scoreTapeCharset(const bcd_histogram_t &histogram,
+                         const parity_glyphs_t &glyphs);
+
+// Index of the best scoring candidate. Ties go to the earliest.
+size_t detectTapeCharset(const bcd_histogram_t &histogram,
+                         std::span<const parity_glyphs_t *const> candidates);
+
 // Pairs a Hollerith encoding with a unicode character
 struct HollerithChar {
 
@@ -269,5 +402,56 @@ const std::vector<HollerithChar> &getFORTRAN704Encoding();
 const std::vector<HollerithChar> &getFORTRANIVEncoding();
 const std::vector<HollerithChar> &getFORTRAN704Encoding4();
 const std::vector<HollerithChar> &getBCDIC1();
+const std::vector<HollerithChar> &getBCDIC2();
+const std::vector<HollerithChar> &getBCD702();
+
+// A charset that can be chosen by name, such as with a --charset option. The
+// tape, CPU and Hollerith tables are all built the first time any of them is
+// used, and are shared after that.
+class NamedCharset {
+public:
+  using tape_chars_t = std::function<BCDCharSet::charmap_t()>;
+  using hollerith_chars_t = std::function<std::vector<HollerithChar>()>;
+
+  // Without hollerithChars, the Hollerith glyphs are those of the tape chars
+  NamedCharset(std::string name, std::string description,
+               tape_chars_t tapeChars, hollerith_chars_t hollerithChars = {});
+  ~NamedCharset();
+
+  const std::string &getName() const { return name_; }
+  const std::string &getDescription() const { return description_; }
+
+  // Glyphs for 7-bit tape frames, including parity error groups
+  const parity_glyphs_t &getTapeGlyphs() const;
+  const GlyphTranscoder &getTapeTranscoder() const;
+
+  // Glyphs in tape order, and text to tape BCD
+  const BCDCharSet &getTapeCharSet() const;
+
+  // Glyphs in CPU order, and text to CPU BCD
+  const BCDCharSet &getCPUCharSet() const;
+
+  // Replacement char if the column has no glyph
+  utf8_string_view_t getHollerithGlyph(hollerith_t column) const;
+
+  std::optional<hollerith_t> getHollerith(unicode_char_t c) const;
+
+private:
+  struct Tables;
+  const Tables &getTables() const;
+
+  std::string name_;
+  std::string description_;
+  tape_chars_t tapeChars_;
+  hollerith_chars_t hollerithChars_;
+  mutable std::once_flag tablesOnce_;
+  mutable std::unique_ptr<Tables> tables_;
+};
+
+// Every named charset. The first, "collated", is the SHARE tape default.
+const std::deque<NamedCharset> &getNamedCharsets();
+
+// nullptr if there is no charset with the name
+const NamedCharset *findNamedCharset(std::string_view name);
 
 #endif
@@ -31,6 +31,185 @@
 #include "Z0ftware/bcd.hpp"
 #include "Z0ftware/hollerith.hpp"
 
+#include <array>
+#include <cstddef>
+#include <span>
+
+// The tables are built at compile time, so each conversion is one load
+namespace convert_tables {
+struct CardTapePair {
+  size_t collate;
+  hollerith_t hc;
+  tape_bcd_t::value_t sc;
+};
+
+inline constexpr CardTapePair cardTapePairs[] = {
+    //
+    {0, hollerith(), 0x10},
+    //
+    {1, hollerith(12, 3, 8), 0x3B},
+    {2, hollerith(12, 4, 8), 0x3C},
+    {3, hollerith(12, 5, 8), 0x3D},
+    {4, hollerith(12, 6, 8), 0x3E},
+    {5, hollerith(12, 7, 8), 0x3F},
+    {6, hollerith(12), 0x30},
+    {7, hollerith(11, 3, 8), 0x2B},
+    {8, hollerith(11, 4, 8), 0x2C},
+    {9, hollerith(11, 5, 8), 0x2D},
+    {10, hollerith(11, 6, 8), 0x2E},
+    {11, hollerith(11, 7, 8), 0x2F},
+    {12, hollerith(11), 0x20},
+    {13, hollerith(0, 1), 0x11},
+    {14, hollerith(0, 3, 8), 0x1B},
+    {15, hollerith(0, 4, 8), 0x1C},
+    {16, hollerith(0, 5, 8), 0x1D},
+    {17, hollerith(0, 6, 8), 0x1E},
+    {18, hollerith(0, 7, 8), 0x1F},
+    // Replaced by blank on tape
+    {19, hollerith(2, 8), 0x00},
+    {20, hollerith(3, 8), 0x0B},
+    {21, hollerith(4, 8), 0x0C},
+    {22, hollerith(5, 8), 0x0D},
+    {23, hollerith(6, 8), 0x0E},
+    {24, hollerith(7, 8), 0x0F},
+    //
+    {25, hollerith(12, 0), 0x3A},
+    {26, hollerith(12, 1), 0x31},
+    {27, hollerith(12, 2), 0x32},
+    {28, hollerith(12, 3), 0x33},
+    {29, hollerith(12, 4), 0x34},
+    {30, hollerith(12, 5), 0x35},
+    {31, hollerith(12, 6), 0x36},
+    {32, hollerith(12, 7), 0x37},
+    {33, hollerith(12, 8), 0x38},
+    {34, hollerith(12, 9), 0x39},
+    //
+    {35, hollerith(11, 0), 0x2A},
+    {36, hollerith(11, 1), 0x21},
+    {37, hollerith(11, 2), 0x22},
+    {38, hollerith(11, 3), 0x23},
+    {39, hollerith(11, 4), 0x24},
+    {40, hollerith(11, 5), 0x25},
+    {41, hollerith(11, 6), 0x26},
+    {42, hollerith(11, 7), 0x27},
+    {43, hollerith(11, 8), 0x28},
+    {44, hollerith(11, 9), 0x29},
+    {45, hollerith(0, 2, 8), 0x1A},
+    {46, hollerith(0, 2), 0x12},
+    {47, hollerith(0, 3), 0x13},
+    {48, hollerith(0, 4), 0x14},
+    {49, hollerith(0, 5), 0x15},
+    {50, hollerith(0, 6), 0x16},
+    {51, hollerith(0, 7), 0x17},
+    {52, hollerith(0, 8), 0x18},
+    {53, hollerith(0, 9), 0x19},
+    {54, hollerith(0), 0x0A},
+    {55, hollerith(1), 0x01},
+    {56, hollerith(2), 0x02},
+    {57, hollerith(3), 0x03},
+    {58, hollerith(4), 0x04},
+    {59, hollerith(5), 0x05},
+    {60, hollerith(6), 0x06},
+    {61, hollerith(7), 0x07},
+    {62, hollerith(8), 0x08},
+    {63, hollerith(9), 0x09}};
+
+constexpr size_t numBCD = 1 << bcd_t::bit_size();
+constexpr size_t numHollerith = 1 << hollerith_t::bit_size();
+
+constexpr bcd_t::value_t cpu704FromTape(bcd_t::value_t bcd) {
+  bcd_t::value_t zone_swap = (0x10 == (bcd & 0x10)) ? (bcd ^ 0x20) : bcd;
+  return 0x0A == zone_swap ? 0x00 : zone_swap;
+}
+
+constexpr bcd_t::value_t tapeFromCPU704(bcd_t::value_t bcd) {
+  bcd_t::value_t zone_swap = (0x10 == (bcd & 0x10)) ? (bcd ^ 0x20) : bcd;
+  return 0x00 == zone_swap ? 0x0A : zone_swap;
+}
+
+constexpr bcd_t::value_t tapeFromHollerith(hollerith_t h) {
+  if (h == hollerith()) {
+    // blank
+    return 0x10;
+  } else if (h == hollerith(0)) {
+    return 0x0A;
+  } else {
+    bcd_t::value_t value = 0;
+    int start_digit = 10;
+    for (int zone = 12; zone >= 10; zone--) {
+      if (h.isSet(zone)) {
+        value |= (zone - 9) * 0x10;
+        start_digit = zone - 1;
+        break;
+      }
+    }
+    for (int digit = start_digit; digit >= 1; digit--) {
+      if (h.isSet(digit)) {
+        value |= digit;
+      }
+    }
+    if (0x0A == value) {
+      value = 0x10;
+    }
+    return value;
+  }
+}
+
+inline constexpr std::array<bcd_t::value_t, numBCD> cpu704FromTapeTable =
+    []() {
+      std::array<bcd_t::value_t, numBCD> table{};
+      for (size_t bcd = 0; bcd < numBCD; ++bcd) {
+        table[bcd] = cpu704FromTape(bcd);
+      }
+      return table;
+    }();
+
+inline constexpr std::array<bcd_t::value_t, numBCD> tapeFromCPU704Table =
+    []() {
+      std::array<bcd_t::value_t, numBCD> table{};
+      for (size_t bcd = 0; bcd < numBCD; ++bcd) {
+        table[bcd] = tapeFromCPU704(bcd);
+      }
+      return table;
+    }();
+
+inline constexpr std::array<hollerith_t::value_t, numBCD>
+    hollerithFromTapeTable = []() {
+      std::array<hollerith_t::value_t, numBCD> table{};
+      for (auto &pair : cardTapePairs) {
+        table[pair.sc] = pair.hc.value();
+      }
+      return table;
+    }();
+
+inline constexpr std::array<hollerith_t::value_t, numBCD>
+    hollerithFromCPU704Table = []() {
+      std::array<hollerith_t::value_t, numBCD> table{};
+      for (size_t bcd = 0; bcd < numBCD; ++bcd) {
+        table[bcd] = hollerithFromTapeTable[tapeFromCPU704(bcd)];
+      }
+      return table;
+    }();
+
+inline constexpr std::array<bcd_t::value_t, numHollerith>
+    tapeFromHollerithTable = []() {
+      std::array<bcd_t::value_t, numHollerith> table{};
+      for (size_t h = 0; h < numHollerith; ++h) {
+        table[h] = tapeFromHollerith(hollerith_t(h));
+      }
+      return table;
+    }();
+
+inline constexpr std::array<bcd_t::value_t, numHollerith>
+    cpu704FromHollerithTable = []() {
+      std::array<bcd_t::value_t, numHollerith> table{};
+      for (size_t h = 0; h < numHollerith; ++h) {
+        table[h] = cpu704FromTape(tapeFromHollerithTable[h]);
+      }
+      return table;
+    }();
+} // namespace convert_tables
+
 // From tape
 template <typename OUT> OUT convert(tape_bcd_t tape_bcd);
 
@@ -38,30 +217,86 @@ template <> inline constexpr tape_bcd_t convert(tape_bcd_t tape_bcd) {
   return tape_bcd;
 }
 
-template <> cpu704_bcd_t convert(tape_bcd_t tape_bcd);
+template <> inline constexpr cpu704_bcd_t convert(tape_bcd_t tape_bcd) {
+  return convert_tables::cpu704FromTapeTable[tape_bcd.value()];
+}
 
-template <> hollerith_t convert(tape_bcd_t tape_bcd);
+template <> inline constexpr hollerith_t convert(tape_bcd_t tape_bcd) {
+  return convert_tables::hollerithFromTapeTable[tape_bcd.value()];
+}
 
 // From CPU
 template <typename OUT> OUT convert(cpu704_bcd_t cpu704_bcd);
 
-template <> tape_bcd_t convert(cpu704_bcd_t cpu704_bcd);
+template <> inline constexpr tape_bcd_t convert(cpu704_bcd_t cpu704_bcd) {
+  return convert_tables::tapeFromCPU704Table[cpu704_bcd.value()];
+}
 
-template <> inline cpu704_bcd_t convert(cpu704_bcd_t cpu704_bcd) {
+template <> inline constexpr cpu704_bcd_t convert(cpu704_bcd_t cpu704_bcd) {
   return cpu704_bcd;
 }
 
-template <> hollerith_t convert(cpu704_bcd_t cpu704_bcd);
+template <> inline constexpr hollerith_t convert(cpu704_bcd_t cpu704_bcd) {
+  return convert_tables::hollerithFromCPU704Table[cpu704_bcd.value()];
+}
 
 // From hollerith
 template <typename OUT> OUT convert(hollerith_t hollerith);
 
-template <> tape_bcd_t convert(hollerith_t hollerith);
+template <> inline constexpr tape_bcd_t convert(hollerith_t hollerith) {
+  return convert_tables::tapeFromHollerithTable[hollerith.value()];
+}
 
-template <> cpu704_bcd_t convert(hollerith_t hollerith);
+template <> inline constexpr cpu704_bcd_t convert(hollerith_t hollerith) {
+  return convert_tables::cpu704FromHollerithTable[hollerith.value()];
+}
 
-template <> inline hollerith_t convert(hollerith_t hollerith) {
+template <> inline constexpr hollerith_t convert(hollerith_t hollerith) {
   return hollerith;
 }
 
+// Bulk conversions; out must be at least as long as in. The BCD to BCD loops
+// are branch-free so the compiler can vectorize them.
+inline void convert(std::span<const tape_bcd_t> in,
+                    std::span<cpu704_bcd_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::cpu704FromTape(in[i].value());
+  }
+}
+
+inline void convert(std::span<const cpu704_bcd_t> in,
+                    std::span<tape_bcd_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::tapeFromCPU704(in[i].value());
+  }
+}
+
+inline void convert(std::span<const tape_bcd_t> in,
+                    std::span<hollerith_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::hollerithFromTapeTable[in[i].value()];
+  }
+}
+
+inline void convert(std::span<const cpu704_bcd_t> in,
+                    std::span<hollerith_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::hollerithFromCPU704Table[in[i].value()];
+  }
+}
+
+inline void convert(std::span<const hollerith_t> in,
+                    std::span<tape_bcd_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::tapeFromHollerithTable[in[i].value()];
+  }
+}
+
+inline void convert(std::span<const hollerith_t> in,
+                    std::span<cpu704_bcd_t> out) {
+  for (size_t i = 0; i < in.size(); ++i) {
+    out[i] = convert_tables::cpu704FromHollerithTable[in[i].value()];
+  }
+}
+
 #endif
@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file decimal.hpp
+ * @brief Decimal numbers for the DEC pseudo-op, converted with exact integer
+ * arithmetic.
+ */
+
+#ifndef Z0FTWARE_DECIMAL_HPP
+#define Z0FTWARE_DECIMAL_HPP
+
+#include "Z0ftware/word.hpp"
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// A decimal number, with the grammar of PegDECParser's Decimal:
+//
+//   Decimal <- ('+' / '-')? ('.' [0-9]+ / [0-9]+ '.'? [0-9]*) ExpBExp
+//   ExpBExp <- Exp BExp / BExp Exp / Exp / BExp / ''
+//   Exp     <- 'E' ('+' / '-')? [0-9]+
+//   BExp    <- 'B' [0-9]{1,2}
+//
+// With a point or an exponent and no binary point, the number is a Float
+// rounded to nearest, ties to even. Otherwise it is a FixPoint with the binary
+// point after bit 35 - BExp, truncated toward 0.
+//
+// On success, next is after the number. Fails if the value does not fit.
+std::optional<Word> parseDecimal(const char *&next, const char *end);
+
+// One or more comma-separated decimal numbers, optionally followed by a space
+// and a comment. On failure, values is unchanged.
+bool parseDEC(std::string_view text, std::vector<Word> &values);
+
+#endif
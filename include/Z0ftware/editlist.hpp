@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef Z0FTWARE_EDITLIST_HPP
+#define Z0FTWARE_EDITLIST_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary form of the edits for a tape. The file can be memory-mapped and the
+// editors read entries as they reach them, so nothing is done per edit when
+// the list is opened.
+//
+// Layout, native byte order:
+//   Header
+//   Entry[numOffsetEdits]        sorted by (begin, end)
+//   Entry[numRecordOffsetEdits]  sorted by (recordNum, begin, end)
+//   char[replacementsSize]       replacement text referenced by entries
+class EditList {
+public:
+  static constexpr char magic[8] = {'Z', '0', 'E', 'D', 'I', 'T', 'S', '1'};
+
+  struct Header {
+    char magic[8];
+    uint64_t numOffsetEdits;
+    uint64_t numRecordOffsetEdits;
+    uint64_t replacementsSize;
+  };
+
+  struct Entry {
+    // Unused for offset edits
+    uint64_t recordNum;
+    int64_t begin;
+    int64_t end;
+    uint64_t replacementPos;
+    uint64_t replacementSize;
+  };
+
+  // Maps fileName, throwing std::runtime_error if it is not an edit list
+  EditList(const std::string &fileName);
+  EditList(const EditList &) = delete;
+  EditList &operator=(const EditList &) = delete;
+  ~EditList();
+
+  // True if the file starts with the edit list magic
+  static bool isEditList(const std::string &fileName);
+
+  std::span<const Entry> getOffsetEdits() const { return offsetEdits_; }
+  std::span<const Entry> getRecordOffsetEdits() const {
+    return recordOffsetEdits_;
+  }
+  std::string_view getReplacement(const Entry &entry) const {
+    return replacements_.substr(entry.replacementPos, entry.replacementSize);
+  }
+
+  // Collects edits and writes them as an edit list
+  class Writer {
+  public:
+    void addEdit(int64_t begin, int64_t end, std::string_view replacement);
+    void addEdit(uint64_t recordNum, int64_t begin, int64_t end,
+                 std::string_view replacement);
+
+    void write(std::ostream &os);
+
+  private:
+    std::vector<Entry> offsetEdits_;
+    std::vector<Entry> recordOffsetEdits_;
+    std::string replacements_;
+  };
+
+private:
+  void *map_{nullptr};
+  size_t mapSize_{0};
+  std::span<const Entry> offsetEdits_;
+  std::span<const Entry> recordOffsetEdits_;
+  std::string_view replacements_;
+};
+
+#endif
@@ -29,8 +29,45 @@
 
 #include "Z0ftware/word.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Interns symbols, numbering them densely in order of first use, so
+// compiled expressions and the assembler can refer to them by slot. The
+// names are in an open-addressing hash table, looked up by string_view.
+class SymbolSlots {
+public:
+  using slot_t = uint32_t;
+
+  // The slot for name, adding it if new
+  slot_t getSlot(std::string_view name);
+  // The slot for name, if it has one
+  std::optional<slot_t> findSlot(std::string_view name) const;
+
+  const std::string &getName(slot_t slot) const { return names_[slot]; }
+  size_t size() const { return names_.size(); }
+
+private:
+  static constexpr slot_t emptySlot = ~slot_t(0);
+
+  // The position in table_ of name, or of the empty entry where it goes
+  size_t probe(std::string_view name, size_t hash) const;
+  void grow();
+
+  // Power of two size, at most half full
+  std::vector<slot_t> table_;
+  // By slot
+  std::vector<size_t> hashes_;
+  std::deque<std::string> names_;
+};
 
 // Access to named locations
 class Environment {
@@ -41,8 +78,15 @@ public:
   // The value of an already defined location
   // Cannot be const since symbols can be defined on first use
   virtual addr_t getSymbolValue(const std::string &string) = 0;
+  // The value of a symbol by its slot, for compiled expressions
+  virtual addr_t getSlotValue(const SymbolSlots &slots,
+                              SymbolSlots::slot_t slot) {
+    return getSymbolValue(slots.getName(slot));
+  }
 };
 
+class CompiledExpr;
+
 class Expr {
 public:
   // Needs to be shared_ptr for parser
@@ -69,6 +113,9 @@ public:
 
   // Evaluate the expression using the environment for definitions
   virtual int evaluate(Environment &environment) const = 0;
+
+  // Append the expression's code to compiled
+  virtual void compile(CompiledExpr &compiled) const = 0;
 };
 
 class AddExpr : public Expr {
@@ -79,6 +126,7 @@ public:
   Expr::ptr &getRight() { return right_; }
 
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   Expr::ptr left_;
@@ -93,6 +141,7 @@ public:
   Expr::ptr &getRight() { return right_; }
 
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   Expr::ptr left_;
@@ -107,6 +156,7 @@ public:
   Expr::ptr &getRight() { return right_; }
 
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   Expr::ptr left_;
@@ -121,6 +171,7 @@ public:
   Expr::ptr &getRight() { return right_; }
 
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   Expr::ptr left_;
@@ -133,6 +184,7 @@ public:
   Expr::ptr &getValue() { return value_; }
 
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   Expr::ptr value_;
@@ -142,12 +194,14 @@ class HereExpr : public Expr {
 public:
   HereExpr() = default;
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 };
 
 class ZeroExpr : public Expr {
 public:
   ZeroExpr() = default;
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 };
 
 class IntegerExpr : public Expr {
@@ -155,6 +209,7 @@ public:
   IntegerExpr(int value) : value_(value) {}
   int &getValue() { return value_; }
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   int value_;
@@ -165,9 +220,139 @@ public:
   SymbolExpr(std::string_view name) : name_(name) {}
   const std::string &getValue() { return name_; }
   int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
 
 private:
   std::string name_;
 };
 
+// An expression as postfix code, with constant subexpressions folded and
+// symbols looked up by slot. SYMBOL+n and *+n are two instructions.
+class CompiledExpr : public Expr {
+public:
+  enum class Op : uint8_t {
+    Const,    // Push arg
+    Here,     // Push the location
+    Symbol,   // Push the value of slot arg
+    AddConst, // Add arg to the top
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate
+  };
+
+  struct Code {
+    Op op;
+    int32_t arg{0};
+  };
+
+  CompiledExpr(const Expr &expr, SymbolSlots &slots);
+
+  const std::vector<Code> &getCode() const { return code_; }
+
+  int evaluate(Environment &environment) const override;
+  void compile(CompiledExpr &compiled) const override;
+
+  // For Expr::compile
+  void emitConst(int value);
+  void emitHere();
+  void emitSymbol(std::string_view name);
+  // Op for a binary operator
+  void emitBinary(Op op);
+  void emitNegate();
+
+private:
+  // Pushes and pops from the stack
+  void adjustDepth(int change);
+
+  SymbolSlots *slots_;
+  std::vector<Code> code_;
+  size_t depth_{0};
+  size_t maxDepth_{0};
+};
+
+// Storage for the nodes of parsed expressions. The nodes are destroyed with
+// the arena.
+class ExprArena {
+public:
+  ExprArena(size_t size) : storage_(size) {}
+  ExprArena(const ExprArena &) = delete;
+  ExprArena &operator=(const ExprArena &) = delete;
+  ~ExprArena();
+
+  // Bytes needed for a node of type T
+  template <typename T> static constexpr size_t nodeSize() {
+    static_assert(alignof(T) <= alignof(Link));
+    return sizeof(Link) + (sizeof(T) + alignof(Link) - 1) / alignof(Link) *
+                              alignof(Link);
+  }
+
+  size_t available() const { return storage_.size() - used_; }
+
+  // nullptr if there is no room
+  template <typename T, typename... Args> T *make(Args &&...args) {
+    constexpr size_t size = nodeSize<T>();
+    if (size > available()) {
+      return nullptr;
+    }
+    Link *link = new (&storage_[used_]) Link{last_, nullptr};
+    T *node = new (link + 1) T(std::forward<Args>(args)...);
+    link->node = node;
+    last_ = link;
+    used_ += size;
+    return node;
+  }
+
+private:
+  // Precedes each node, for destruction
+  struct alignas(std::max_align_t) Link {
+    Link *prev;
+    Expr *node;
+  };
+
+  std::vector<std::byte> storage_;
+  size_t used_{0};
+  Link *last_{nullptr};
+};
+
+// Recursive descent parser for one or more comma-separated expressions, with
+// the same grammar as PegEXPParser, which is kept as the reference:
+//
+//   EXP    <- Expr (',' Expr)* (' ' .*)?
+//   Expr   <- Mult ('+' / '-') Expr / Mult
+//   Mult   <- SValue ('*' / '/') Mult / SValue
+//   SValue <- '-' Value / '+' Value / Value
+//   Value  <- '**' / '*' / [0-9A-Z#@_&.%]+ / ''
+//
+// The operators are right-associative and an empty Value is 0. A symbol of
+// only digits is an integer.
+//
+// The nodes of many parses share an arena. Each parsed expression holds the
+// arena but the subexpressions do not, so a subexpression is only valid while
+// its expression is held.
+class EXPParser {
+public:
+  // On failure, exprs is unchanged
+  bool parse(std::string_view text, std::vector<Expr::ptr> &exprs);
+
+private:
+  Expr::ptr parseExpr();
+  Expr::ptr parseMult();
+  Expr::ptr parseSValue();
+  Expr::ptr parseValue();
+
+  bool atChar(char c) const { return next_ < end_ && *next_ == c; }
+
+  // A node in the arena, without ownership
+  template <typename T, typename... Args> Expr::ptr make(Args &&...args) {
+    return Expr::ptr(Expr::ptr(),
+                     arena_->make<T>(std::forward<Args>(args)...));
+  }
+
+  std::shared_ptr<ExprArena> arena_;
+  const char *next_{nullptr};
+  const char *end_{nullptr};
+};
+
 #endif
\ No newline at end of file
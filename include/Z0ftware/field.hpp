@@ -359,8 +359,8 @@ public:
     return *this;
   }
 
-  explicit operator const value_t &() const { return value_; }
-  explicit operator value_t &() { return value_; }
+  explicit constexpr operator const value_t &() const { return value_; }
+  explicit constexpr operator value_t &() { return value_; }
 
   constexpr const value_t &value() const { return value_; }
   constexpr value_t &value() { return value_; }
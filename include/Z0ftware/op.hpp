@@ -24,13 +24,109 @@
 #define Z0FTWARE_OP_HPP
 
 #include "Z0ftware/field.hpp"
+#include "Z0ftware/utils.hpp"
 #include "Z0ftware/word.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <initializer_list>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+// A SAP mnemonic packed into 18 bits, six bits of 704 BCD per character,
+// big-endian and padded with blanks.
+using mnemonic_key_t = uint32_t;
+
+/**
+ * @brief Packs an operation mnemonic of up to three letters, digits or blanks.
+ * @returns The key, or nothing if name cannot be a mnemonic.
+ */
+constexpr std::optional<mnemonic_key_t> mnemonicKey(std::string_view name) {
+  if (name.size() > 3) {
+    return std::nullopt;
+  }
+  mnemonic_key_t key = 0;
+  for (size_t i = 0; i < 3; ++i) {
+    char c = i < name.size() ? name[i] : ' ';
+    mnemonic_key_t bcd;
+    if (c >= '0' && c <= '9') {
+      bcd = c - '0';
+    } else if (c >= 'A' && c <= 'I') {
+      bcd = 021 + (c - 'A');
+    } else if (c >= 'J' && c <= 'R') {
+      bcd = 041 + (c - 'J');
+    } else if (c >= 'S' && c <= 'Z') {
+      bcd = 062 + (c - 'S');
+    } else if (c == ' ') {
+      bcd = 060;
+    } else {
+      return std::nullopt;
+    }
+    key = (key << 6) | bcd;
+  }
+  return key;
+}
+
+/**
+ * @brief A perfect hash from mnemonics to values, so a lookup is one probe.
+ *
+ * The hash is found with findPerfectHash when the table is built.
+ */
+template <typename Value> class MnemonicTable {
+public:
+  using Entry = std::pair<std::string_view, Value>;
+
+  MnemonicTable(std::initializer_list<Entry> entries) { build(entries); }
+  MnemonicTable(const std::vector<Entry> &entries) { build(entries); }
+
+  const Value *find(std::string_view name) const {
+    auto key = mnemonicKey(name);
+    if (!key) {
+      return nullptr;
+    }
+    auto &slot = slots_[hash_(*key)];
+    return slot.first == *key ? &slot.second : nullptr;
+  }
+
+private:
+  static constexpr mnemonic_key_t emptyKey = ~mnemonic_key_t(0);
+  static constexpr unsigned keyBits = 18;
+
+  template <typename Entries> void build(const Entries &entries) {
+    // Later entries replace earlier ones
+    std::vector<std::pair<mnemonic_key_t, Value>> keyed;
+    for (const auto &[name, value] : entries) {
+      auto key = mnemonicKey(name);
+      if (!key) {
+        throw std::invalid_argument("Not a mnemonic: " + std::string(name));
+      }
+      auto it = std::find_if(keyed.begin(), keyed.end(),
+                             [&key](auto &item) { return item.first == *key; });
+      if (it == keyed.end()) {
+        keyed.emplace_back(*key, value);
+      } else {
+        it->second = value;
+      }
+    }
+    std::vector<uint32_t> keys;
+    for (const auto &item : keyed) {
+      keys.push_back(item.first);
+    }
+    hash_ = findPerfectHash(keys, keyBits);
+    slots_.assign(hash_.size(), {emptyKey, Value()});
+    for (const auto &item : keyed) {
+      slots_[hash_(item.first)] = item;
+    }
+  }
+
+  MultiplicativeHash hash_;
+  std::vector<std::pair<mnemonic_key_t, Value>> slots_;
+};
+
 class OpSpec {
 public:
   using Prefix = BitField<35 - 2, 3>;
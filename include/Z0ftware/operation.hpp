@@ -100,6 +100,12 @@ public:
   [[nodiscard]] const std::vector<std::shared_ptr<Expr>> &getExprs() const {
     return exprs_;
   }
+  // Replace the exprs with their compiled forms
+  void compileExprs(SymbolSlots &slots) {
+    for (auto &expr : exprs_) {
+      expr = std::make_shared<CompiledExpr>(*expr, slots);
+    }
+  }
 
   class Report {
   public:
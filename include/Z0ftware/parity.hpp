@@ -26,6 +26,7 @@
 #include "Z0ftware/bcd.hpp"
 
 #include <array>
+#include <cstdint>
 
 class bcd_t;
 
@@ -63,4 +64,48 @@ const std::array<even_parity_bcd_t, 1 << 6> &getEvenParityTable();
 odd_parity_bcd_t oddParity(bcd_t bcd_t);
 const std::array<odd_parity_bcd_t, 1 << 6> &getOddParityTable();
 
+// A frame is a byte read from a tape or card image: a six bit value, a parity
+// bit and, for the first frame of a record, a mark in bit 7.
+//
+// frameDecodeTable[frame] has the six bit value in bits 0-5, frameEvenOk if
+// bits 0-6 of the frame have even parity and frameOddOk if they have odd
+// parity.
+constexpr uint8_t frameValueMask = 0x3F;
+constexpr uint8_t frameEvenOk = 0x40;
+constexpr uint8_t frameOddOk = 0x80;
+
+inline constexpr std::array<uint8_t, 256> frameDecodeTable = []() {
+  std::array<uint8_t, 256> table{};
+  for (unsigned frame = 0; frame < 256; ++frame) {
+    unsigned bits = 0;
+    for (unsigned bit = 0; bit < 7; ++bit) {
+      bits += (frame >> bit) & 1;
+    }
+    table[frame] = (frame & frameValueMask) |
+                   ((bits & 1) ? frameOddOk : frameEvenOk);
+  }
+  return table;
+}();
+
+// Frames for six bit values with even and odd parity
+inline constexpr std::array<uint8_t, 64> evenFrameTable = []() {
+  std::array<uint8_t, 64> table{};
+  for (unsigned value = 0; value < 64; ++value) {
+    for (uint8_t frame : {uint8_t(value), uint8_t(value | 0x40)}) {
+      if (frameDecodeTable[frame] & frameEvenOk) {
+        table[value] = frame;
+      }
+    }
+  }
+  return table;
+}();
+
+inline constexpr std::array<uint8_t, 64> oddFrameTable = []() {
+  std::array<uint8_t, 64> table{};
+  for (unsigned value = 0; value < 64; ++value) {
+    table[value] = evenFrameTable[value] ^ 0x40;
+  }
+  return table;
+}();
+
 #endif
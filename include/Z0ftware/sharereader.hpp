@@ -25,6 +25,9 @@
 
 #include "Z0ftware/tape.hpp"
 
+#include <iterator>
+#include <span>
+
 // How to tell when the next deck has started? Short symbolic record?
 // Records should be multiples of 72/80/84(?)
 // BCD/binary is determined by whether majority of chars are even/odd parity
@@ -43,9 +46,11 @@
 // deck, which consists of one or more records or multiple cards each. Blank
 // cards pad the record to uniform size.
 //
-// TODO: Don't implement TapeIRecordStream; instead use a record-invisible
-// deck/card interface where the header card record size determines the card
-// width for the deck.
+// The cards of a deck can be read without regard to records with nextCard()
+// or getCards(). The header card record size determines the card width for the
+// deck.
+//
+// TODO: Don't implement TapeIRecordStream
 class ShareReader
     : public Delegate<TapeIRecordStream, TapeIRecordStream, TapeIRecordStream> {
   using delegate_t =
@@ -67,6 +72,53 @@ public:
   // Reads 7-bit from the deck data. Returns 0 at end of record.
   std::streamsize read(char *buffer, std::streamsize count) override;
 
+  // Width of the cards in the deck
+  size_t getCardSize() { return getDeckHeader().size(); }
+
+  // Returns the next card of the deck, or an empty span at end of deck. The
+  // span points into the record buffer and is valid until the next read. The
+  // last card of a record may be short.
+  std::span<const char> nextCard();
+
+  // Offset of the last card from getRecordPos()
+  off_type getCardOffset() const { return cardOffset_; }
+
+  // Input iterator over the remaining cards of the deck
+  class CardIterator {
+  public:
+    using value_type = std::span<const char>;
+    using difference_type = std::ptrdiff_t;
+
+    CardIterator() = default;
+    CardIterator(ShareReader &shareReader) : shareReader_(&shareReader) {
+      ++*this;
+    }
+
+    value_type operator*() const { return card_; }
+    CardIterator &operator++() {
+      card_ = shareReader_->nextCard();
+      if (card_.empty()) {
+        shareReader_ = nullptr;
+      }
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    bool operator==(std::default_sentinel_t) const { return !shareReader_; }
+
+  private:
+    ShareReader *shareReader_{nullptr};
+    value_type card_;
+  };
+
+  struct Cards {
+    ShareReader &shareReader;
+    CardIterator begin() { return CardIterator(shareReader); }
+    std::default_sentinel_t end() { return std::default_sentinel; }
+  };
+
+  // for (auto card : shareReader.getCards()) ...
+  Cards getCards() { return Cards{*this}; }
+
   bool isBCD() const { return isBCD_; }
   bool isBinary() const { return !isBCD_; }
 
@@ -85,15 +137,18 @@ protected:
   static constexpr size_t recordBufferSize_ = 4096;
   std::array<char, recordBufferSize_> recordBuffer_{0};
   char *recordBufferStart_{recordBuffer_.data()};
-  char *recordBufferEnd_;
-  char *recordBufferNext_;
+  char *recordBufferEnd_{recordBuffer_.data()};
+  char *recordBufferNext_{recordBuffer_.data()};
+  // Offset of recordBufferStart_ in the record
+  off_type recordBufferOffset_{0};
+  off_type cardOffset_{0};
   bool recordBufferHasHeader_{false};
   bool isBCD_{false};
 
   static constexpr size_t headerBufferSize_ = 84;
   std::array<char, headerBufferSize_> headerBuffer_{0};
   char *headerBufferStart_{headerBuffer_.data()};
-  char *headerBufferEnd_;
+  char *headerBufferEnd_{headerBuffer_.data()};
 };
 
 #endif
@@ -87,7 +87,8 @@ public:
   pos_type tellg() const override { return input_.tellg(); };
 
   bool eof() const override { return input_.eof(); };
-  bool fail() const override { return input_.fail(); };
+  // A short read at the end of the stream sets failbit, but is not a failure
+  bool fail() const override { return input_.fail() && !input_.eof(); };
 
 protected:
   stream_type &input_;
@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef Z0FTWARE_TAPEDIFF_HPP
+#define Z0FTWARE_TAPEDIFF_HPP
+
+#include "Z0ftware/tape.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The records of a tape image, as seen through a TapeIRecordStream. Record
+// numbers match TapeIRecordStream::getRecordNum() so they can be used for
+// record-offset edits.
+class TapeRecords {
+public:
+  struct Record {
+    size_t recordNum;
+    Reader::pos_type pos;
+    size_t begin;
+    size_t size;
+    uint64_t hash;
+  };
+
+  // Reads every record from input
+  TapeRecords(TapeIRecordStream &input);
+
+  const std::vector<Record> &getRecords() const { return records_; }
+  std::string_view getData(const Record &record) const {
+    return std::string_view(data_).substr(record.begin, record.size);
+  }
+
+  static uint64_t hash(std::string_view data);
+
+private:
+  std::string data_;
+  std::vector<Record> records_;
+};
+
+// A run of records that differ between two tapes. Records [leftBegin,
+// leftEnd) of the left tape are replaced by [rightBegin, rightEnd) of the
+// right tape. Indices are into TapeRecords::getRecords().
+struct TapeDiffHunk {
+  size_t leftBegin;
+  size_t leftEnd;
+  size_t rightBegin;
+  size_t rightEnd;
+};
+
+// Aligns two hash sequences using patience diff and returns the hunks where
+// they differ.
+std::vector<TapeDiffHunk> diffHashes(const std::vector<uint64_t> &left,
+                                     const std::vector<uint64_t> &right);
+
+std::vector<TapeDiffHunk> diffRecords(const TapeRecords &left,
+                                      const TapeRecords &right);
+
+#endif
@@ -23,8 +23,13 @@
 #ifndef Z0FTWARE_TAPEEDITSTREAM_HPP
 #define Z0FTWARE_TAPEEDITSTREAM_HPP
 
+#include "Z0ftware/editlist.hpp"
 #include "Z0ftware/tape.hpp"
 
+#include <deque>
+#include <string>
+#include <string_view>
+
 // This should work on TapeIRecordStream since since record encoding might not
 // correspond to bytes in the input
 class ReaderEditor : public Delegate<Reader, Reader, Reader> {
@@ -33,6 +38,8 @@ public:
 
   // Replace chars in [begin, end) with replacement
   void addEdit(pos_type begin, pos_type end, std::string replacement);
+  // Also apply the offset edits of editList, which must outlive the editor
+  void addEdits(const EditList &editList) { editList_ = &editList; }
 
   std::streamsize read(char *buffer, std::streamsize count) override;
 
@@ -40,7 +47,7 @@ protected:
   struct Edit {
     off_type begin{0};
     off_type end{0};
-    std::string replacement{""};
+    std::string_view replacement{""};
 
     friend auto operator<=>(const Edit &e1, const Edit &e2) {
       auto high = (e1.begin <=> e2.begin);
@@ -48,8 +55,14 @@ protected:
     }
   };
 
+  // Next edit in order from edits_ and editList_, false if there are no more
+  bool takeEdit(Edit &edit);
+
+  std::deque<std::string> replacements_;
   std::set<Edit> edits_;
   std::set<Edit>::iterator editIt_;
+  const EditList *editList_{nullptr};
+  size_t editListPos_{0};
   Edit nextEdit_{.begin = 0, .end = 0, .replacement = ""};
   bool initialized_{false};
   off_type tellg_{0};
@@ -63,6 +76,9 @@ public:
   // Replace [first, last) in recordNum with replacement
   void addEdit(size_t recordNum, pos_type begin, pos_type end,
                std::string replacement);
+  // Also apply the record-offset edits of editList, which must outlive the
+  // editor
+  void addEdits(const EditList &editList) { editList_ = &editList; }
 
   std::streamsize read(char *buffer, std::streamsize count) override;
 
@@ -71,7 +87,7 @@ protected:
     size_t recordNum{0};
     off_type begin{0};
     off_type end{0};
-    std::string replacement{""};
+    std::string_view replacement{""};
 
     friend auto operator<=>(const Edit &e1, const Edit &e2) {
       auto record = (e1.recordNum <=> e2.recordNum);
@@ -80,8 +96,14 @@ protected:
     }
   };
 
+  // Next edit in order from edits_ and editList_, false if there are no more
+  bool takeEdit(Edit &edit);
+
+  std::deque<std::string> replacements_;
   std::set<Edit> edits_;
   std::set<Edit>::iterator editIt_;
+  const EditList *editList_{nullptr};
+  size_t editListPos_{0};
   Edit nextEdit_{.recordNum = 0, .begin = 0, .end = 0, .replacement = ""};
   bool initialized_{false};
   off_type tellg_{0};
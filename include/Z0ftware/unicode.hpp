@@ -28,7 +28,9 @@
 #ifndef Z0FTWARE_UNICODE
 #define Z0FTWARE_UNICODE
 
-#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <string_view>
 
@@ -43,6 +45,138 @@ using utf8_string_view_t = std::string_view;
 
 static const utf8_t utf8_replacement{"�"};
 
+//! Most bytes in the utf-8 encoding of one unicode char
+static constexpr size_t utf8_max_size{4};
+
+/**
+ * @brief Writes the utf-8 encoding of c.
+ * @arg c The unicode char. Values past U+10FFFF are written as the replacement
+ * char.
+ * @arg out Must have room for utf8_max_size bytes.
+ * @returns The number of bytes written.
+ */
+static constexpr size_t encodeUtf8(unicode_char_t c, char *out) {
+  if (c < 0x80) {
+    out[0] = char(c);
+    return 1;
+  } else if (c < 0x800) {
+    out[0] = char((c >> 6) | 0xC0);
+    out[1] = char((c & 0x3F) | 0x80);
+    return 2;
+  } else if (c < 0x10000) {
+    out[0] = char((c >> 12) | 0xE0);
+    out[1] = char(((c >> 6) & 0x3F) | 0x80);
+    out[2] = char((c & 0x3F) | 0x80);
+    return 3;
+  } else if (c < 0x110000) {
+    out[0] = char((c >> 18) | 0xF0);
+    out[1] = char(((c >> 12) & 0x3F) | 0x80);
+    out[2] = char(((c >> 6) & 0x3F) | 0x80);
+    out[3] = char((c & 0x3F) | 0x80);
+    return 4;
+  }
+  return encodeUtf8(unicode_replacement_char, out);
+}
+
+/**
+ * @brief Decodes the unicode char at the start of a utf-8 string view.
+ * @arg sv A utf-8 string view.
+ * @arg c Set to the unicode char, or the replacement char if sv does not start
+ * with valid utf-8. Overlong encodings and surrogates are not valid.
+ * @returns The number of bytes in the char, or 0 if not valid.
+ */
+static constexpr size_t decodeUtf8(utf8_string_view_t sv, unicode_char_t &c) {
+  c = unicode_replacement_char;
+  if (sv.empty()) {
+    return 0;
+  }
+  unicode_char_t c0 = static_cast<unsigned char>(sv[0]);
+  if (c0 < 0x80) {
+    c = c0;
+    return 1;
+  }
+  size_t size;
+  unicode_char_t result;
+  unicode_char_t min;
+  if (0xC0 == (c0 & 0xE0)) {
+    size = 2;
+    result = c0 & 0x1F;
+    min = 0x80;
+  } else if (0xE0 == (c0 & 0xF0)) {
+    size = 3;
+    result = c0 & 0x0F;
+    min = 0x800;
+  } else if (0xF0 == (c0 & 0xF8)) {
+    size = 4;
+    result = c0 & 0x07;
+    min = 0x10000;
+  } else {
+    return 0;
+  }
+  if (sv.size() < size) {
+    return 0;
+  }
+  for (size_t i = 1; i < size; ++i) {
+    unicode_char_t ci = static_cast<unsigned char>(sv[i]);
+    if (0x80 != (ci & 0xC0)) {
+      // Missing 10
+      return 0;
+    }
+    result = (result << 6) | (ci & 0x3F);
+  }
+  if (result < min || result >= 0x110000 ||
+      (result >= 0xD800 && result < 0xE000)) {
+    return 0;
+  }
+  c = result;
+  return size;
+}
+
+/**
+ * @brief Appends the utf-8 encoding of a unicode string.
+ */
+static void encodeUtf8(unicode_string_view_t sv, utf8_t &out) {
+  size_t pos = out.size();
+  out.resize(pos + sv.size() * utf8_max_size);
+  for (auto c : sv) {
+    pos += encodeUtf8(c, out.data() + pos);
+  }
+  out.resize(pos);
+}
+
+/**
+ * @brief Appends the unicode chars of a utf-8 string. Each byte that does not
+ * start a valid utf-8 char becomes a replacement char.
+ *
+ * Text is almost all ASCII, so eight bytes at a time are checked for a high
+ * bit and, when there is none, widened without decoding.
+ */
+static void decodeUtf8(utf8_string_view_t sv, unicode_string_t &out) {
+  static constexpr uint64_t highBits{0x8080808080808080};
+  size_t pos = out.size();
+  out.resize(pos + sv.size());
+  const char *next = sv.data();
+  const char *end = next + sv.size();
+  while (next < end) {
+    if (end - next >= 8) {
+      uint64_t word;
+      std::memcpy(&word, next, sizeof(word));
+      if (0 == (word & highBits)) {
+        for (size_t i = 0; i < 8; ++i) {
+          out[pos++] = static_cast<unsigned char>(next[i]);
+        }
+        next += 8;
+        continue;
+      }
+    }
+    unicode_char_t c;
+    size_t size = decodeUtf8(utf8_string_view_t(next, end - next), c);
+    out[pos++] = c;
+    next += size ? size : 1;
+  }
+  out.resize(pos);
+}
+
 static utf8_t get_utf8_char(const utf8_t &utf8);
 
 static utf8_t get_utf8_char(unicode_char_t c);
@@ -68,41 +202,15 @@ public:
    */
   template <typename S>
   friend inline auto &operator<<(S &os, const Unicode &unicode) {
-    static constexpr char32_t uni_1{0x80};
-    static constexpr char32_t uni_2{0x800};
-    static constexpr char32_t uni_3{0x10000};
-    static constexpr char32_t uni_4{0x110000};
-
-    if (unicode.unicode_ < uni_1) {
-      return os.put(char(unicode.unicode_));
-    } else if (unicode.unicode_ < uni_2) {
-      return os.put(char((unicode.unicode_ >> 6) | 0xC0))
-          .put(char((unicode.unicode_ & 0x3F) | 0x80));
-    } else if (unicode.unicode_ < uni_3) {
-      return os.put(char((unicode.unicode_ >> 12) | 0xE0))
-          .put(char(((unicode.unicode_ >> 6) & 0x3F) | 0x80))
-          .put(char((unicode.unicode_ & 0x3F) | 0x80));
-    } else if (unicode.unicode_ < uni_4) {
-      return os.put(char(((unicode.unicode_ >> 18) & 0x7) | 0xF0))
-          .put(char(((unicode.unicode_ >> 12) & 0x3F) | 0x80))
-          .put(char(((unicode.unicode_ >> 6) & 0x3F) | 0x80))
-          .put(char((unicode.unicode_ & 0x3F) | 0x80));
-    } else {
-      return os.put(char((unicode_replacement_char >> 12) | 0xE0))
-          .put(char(((unicode_replacement_char >> 6) & 0x3F) | 0x80))
-          .put(char((unicode_replacement_char & 0x3F) | 0x80));
-    }
+    char utf8[utf8_max_size];
+    return os.write(utf8, encodeUtf8(unicode.unicode_, utf8));
   }
 
   bool operator==(const Unicode &) const = default;
   bool operator!=(const Unicode &) const = default;
   operator bool() const { return unicode_ == unicode_replacement_char; }
 
-  operator utf8_t() const {
-    std::ostringstream os;
-    os << *this;
-    return os.str();
-  }
+  operator utf8_t() const { return get_utf8_char(unicode_); }
 
 protected:
   unicode_char_t unicode_{unicode_replacement_char};
@@ -113,57 +221,19 @@ protected:
  * @brief Removes the next unicode char from the prefix of the utf-8 string
  * view.
  * @arg sv A utf-8 string view.
- * @returns The unicode char32_t. Replacement char is returned if utf-8 is
+ * @returns The utf-8 for the char. Replacement char is returned if utf-8 is
  * not valid.
  */
 static utf8_string_view_t get_next_utf8_char(utf8_string_view_t &sv) {
-  if (sv.empty()) {
+  unicode_char_t c;
+  size_t size = decodeUtf8(sv, c);
+  if (0 == size) {
+    sv.remove_prefix(std::min<size_t>(1, sv.size()));
     return utf8_replacement;
   }
-  utf8_string_view_t base_sv = sv;
-  unicode_char_t c0 = sv.at(0);
-  sv.remove_prefix(1);
-
-  if (0 == (c0 & 0x80)) {
-    return base_sv.substr(0, 1);
-  } else if (0xC0 != (c0 & 0xC0)) {
-    // High two bits must be 1
-    return utf8_replacement;
-  }
-  if (sv.empty()) {
-    return utf8_replacement;
-  }
-  unicode_char_t c1 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c1 & 0xC0)) {
-    // Missing 10
-    return utf8_replacement;
-  }
-  if (0xC0 == (c0 & 0xE0)) {
-    return base_sv.substr(0, 2);
-  }
-  if (sv.empty()) {
-    return utf8_replacement;
-  }
-  unicode_char_t c2 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c2 & 0xC0)) {
-    // Missing prefix
-    return utf8_replacement;
-  }
-  if (0xE0 == (c0 & 0xF0)) {
-    return base_sv.substr(0, 3);
-  }
-  unicode_char_t c3 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c2 & 0xC0)) {
-    // Missing prefix
-    return utf8_replacement;
-  }
-  if (0xF0 == (c0 & 0xF8)) {
-    return base_sv.substr(0, 4);
-  }
-  return utf8_replacement;
+  utf8_string_view_t result = sv.substr(0, size);
+  sv.remove_prefix(size);
+  return result;
 }
 
 /**
@@ -174,53 +244,10 @@ static utf8_string_view_t get_next_utf8_char(utf8_string_view_t &sv) {
  * not valid.
  */
 static unicode_char_t get_next_unicode_char(utf8_string_view_t &sv) {
-  if (sv.empty()) {
-    return unicode_replacement_char;
-  }
-  unicode_char_t c0 = sv.at(0);
-  sv.remove_prefix(1);
-
-  if (0 == (c0 & 0x80)) {
-    return c0;
-  } else if (0xC0 != (c0 & 0xC0)) {
-    // High two bits must be 1
-    return unicode_replacement_char;
-  }
-  if (sv.empty()) {
-    return unicode_replacement_char;
-  }
-  unicode_char_t c1 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c1 & 0xC0)) {
-    // Missing 10
-    return unicode_replacement_char;
-  }
-  if (0xC0 == (c0 & 0xE0)) {
-    return ((c0 & 0x1F) << 6) | (c1 & 0x3F);
-  }
-  if (sv.empty()) {
-    return unicode_replacement_char;
-  }
-  unicode_char_t c2 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c2 & 0xC0)) {
-    // Missing prefix
-    return unicode_replacement_char;
-  }
-  if (0xE0 == (c0 & 0xF0)) {
-    return ((c0 & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (c2 & 0x3F);
-  }
-  unicode_char_t c3 = sv.at(0);
-  sv.remove_prefix(1);
-  if (0x80 != (c2 & 0xC0)) {
-    // Missing prefix
-    return unicode_replacement_char;
-  }
-  if (0xF0 == (c0 & 0xF8)) {
-    return ((c0 & 0x7) << 18) | ((c1 & 0x3F) << 12) | ((c2 & 0x3F) << 6) |
-           (c3 & 0x3F);
-  }
-  return unicode_replacement_char;
+  unicode_char_t c;
+  size_t size = decodeUtf8(sv, c);
+  sv.remove_prefix(std::min<size_t>(size ? size : 1, sv.size()));
+  return c;
 }
 
 static unicode_char_t get_unicode_char(unicode_char_t c) { return c; }
@@ -233,28 +260,20 @@ static unicode_char_t get_unicode_char(unicode_char_t c) { return c; }
  */
 template <typename T> static unicode_char_t get_unicode_char(T s) {
   utf8_string_view_t sv(s);
-  if (sv.empty()) {
-    return unicode_replacement_char;
-  }
-  unicode_char_t c = get_next_unicode_char(sv);
-  return sv.empty() ? c : unicode_replacement_char;
+  unicode_char_t c;
+  return decodeUtf8(sv, c) == sv.size() ? c : unicode_replacement_char;
 }
 
 class UnicodeString {
 public:
   template <typename T> UnicodeString(T arg) {
-    utf8_string_view_t sv(arg);
-    while (!sv.empty()) {
-      unicode_.push_back(get_next_unicode_char(sv));
-    }
+    decodeUtf8(utf8_string_view_t(arg), unicode_);
   }
 
   operator std::string() const {
-    std::ostringstream result;
-    for (auto &c : unicode_) {
-      result << Unicode(c);
-    }
-    return result.str();
+    std::string result;
+    encodeUtf8(unicode_, result);
+    return result;
   }
 
   template <typename S>
@@ -268,9 +287,8 @@ public:
 static utf8_t get_utf8_char(const utf8_t &utf8) { return utf8; }
 
 static utf8_t get_utf8_char(unicode_char_t c) {
-  std::ostringstream os;
-  os << Unicode(c);
-  return os.str();
+  char utf8[utf8_max_size];
+  return utf8_t(utf8, encodeUtf8(c, utf8));
 }
 
 #endif
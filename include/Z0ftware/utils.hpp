@@ -23,7 +23,9 @@
 #ifndef Z0FTWARE_UTILS_HPP
 #define Z0FTWARE_UTILS_HPP
 
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <sstream>
 #include <string>
 
@@ -46,6 +48,24 @@ std::ostream &operator<<(std::ostream &os, const T &t) {
 std::string_view trim(std::string_view text);
 std::string_view rightTrim(std::string_view text);
 
+// A multiplicative hash of 32-bit keys into a table of 2^bits slots
+struct MultiplicativeHash {
+  unsigned bits{1};
+  uint32_t multiplier{1};
+
+  size_t size() const { return size_t(1) << bits; }
+  size_t operator()(uint32_t key) const {
+    return uint32_t(key * multiplier) >> (32 - bits);
+  }
+};
+
+// A hash that maps the distinct keys, each less than 2^keyBits, to distinct
+// slots of a table at least twice the number of keys. Multipliers are tried
+// for each table size below 2^keyBits; if none works, the hash is the
+// identity on a table of 2^keyBits slots.
+MultiplicativeHash findPerfectHash(std::span<const uint32_t> keys,
+                                   unsigned keyBits);
+
 // Formats a string and calls a handler with the string upon destruction.
 class MessageGenerator {
 public:
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file views.hpp
+ * @brief Range adaptors for the character conversions.
+ *
+ * The adaptors are lazy and chain without intermediate buffers, so a tape
+ * record can be read as CPU BCD with
+ *
+ *   for (cpu704_bcd_t c : record | views::tape_bcd | views::to_cpu704)
+ *
+ * or written as text with
+ *
+ *   std::ranges::copy(record | views::glyphs(charset) | std::views::join, out);
+ *
+ * Each element is a table lookup. To convert a whole contiguous span, the bulk
+ * convert() overloads are faster since their loops vectorize.
+ */
+
+#ifndef Z0FTWARE_VIEWS_HPP
+#define Z0FTWARE_VIEWS_HPP
+
+#include "Z0ftware/bcd.hpp"
+#include "Z0ftware/charset.hpp"
+#include "Z0ftware/convert.hpp"
+#include "Z0ftware/hollerith.hpp"
+#include "Z0ftware/parity.hpp"
+
+#include <ranges>
+#include <type_traits>
+
+namespace views {
+// Tape frames to tape BCD, with parity and bit 7 ignored
+inline constexpr auto tape_bcd = std::views::transform(
+    [](char frame) { return tape_bcd_t(frame & 0x3F); });
+
+inline constexpr auto to_tape_bcd = std::views::transform(
+    [](auto value) { return convert<tape_bcd_t>(value); });
+
+inline constexpr auto to_cpu704 = std::views::transform(
+    [](auto value) { return convert<cpu704_bcd_t>(value); });
+
+inline constexpr auto to_hollerith = std::views::transform(
+    [](auto value) { return convert<hollerith_t>(value); });
+
+// Tape frames, or tape BCD, CPU BCD or Hollerith values, to utf-8 glyphs. The
+// glyphs must outlive the view.
+inline auto glyphs(const parity_glyphs_t &tapeGlyphs) {
+  return std::views::transform(
+      [&tapeGlyphs](auto value) -> utf8_string_view_t {
+        if constexpr (std::is_same_v<decltype(value), char>) {
+          return tapeGlyphs[value & 0x7F];
+        } else {
+          return tapeGlyphs[evenFrameTable[convert<tape_bcd_t>(value).value()]];
+        }
+      });
+}
+
+inline auto glyphs(const NamedCharset &charset) {
+  return glyphs(charset.getTapeGlyphs());
+}
+} // namespace views
+
+#endif
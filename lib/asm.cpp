@@ -23,12 +23,22 @@
 #include "Z0ftware/asm.hpp"
 #include "Z0ftware/parser.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 addr_t AssemblerEnvironment::getSymbolValue(const std::string &symbol) {
   return assembler_.getSymbolValue(symbol);
 }
 
+addr_t AssemblerEnvironment::getSlotValue(const SymbolSlots &slots,
+                                          SymbolSlots::slot_t slot) {
+  if (&slots == &assembler_.getSymbolSlots()) {
+    return assembler_.getSymbolValue(slot);
+  }
+  return Environment::getSlotValue(slots, slot);
+}
+
 addr_t AssemblerEnvironment::getLocation() const {
   return chunk_.getBaseAddr();
 }
@@ -48,9 +58,11 @@ Assembler::splitVariableAndComment(
 
 std::vector<Expr::ptr> Assembler::parseEXP(Operation &operation,
                                            const std::string_view &variable) {
-  static PegEXPParser parser;
+  static EXPParser parser;
+  static PegEXPParser pegParser;
   std::vector<Expr::ptr> values;
-  if (!parser.parse(variable, values)) {
+  if (!(pegEXP_ ? pegParser.parse(variable, values)
+                : parser.parse(variable, values))) {
     operation.addError() << "Could not parse expressions";
   };
   return values;
@@ -59,6 +71,7 @@ std::vector<Expr::ptr> Assembler::parseEXP(Operation &operation,
 void Assembler::appendOperation(std::unique_ptr<Operation> &&operation) {
   operation->validate(*this);
   if (!operation->hasErrors()) {
+    operation->compileExprs(symbolSlots_);
     auto &section = operation->getSection(*this);
     auto &chunk = section.getChunks().emplace_back(std::move(operation),
                                                    section.getNextAddr());
@@ -99,16 +112,66 @@ void Assembler::assemble() {
   }
 }
 
-[[nodiscard]] addr_t Assembler::getSymbolValue(const std::string &symbol) {
-  auto it = symbolValues_.find(symbol);
-  if (it != symbolValues_.end()) {
-    return it->second;
+FixPoint &Assembler::operator[](const std::string_view &symbol) {
+  auto slot = symbolSlots_.getSlot(symbol);
+  if (slot >= slotValues_.size()) {
+    slotValues_.resize(slot + 1);
+  }
+  auto &value = slotValues_[slot];
+  if (!value) {
+    value = FixPoint();
+  }
+  return *value;
+}
+
+void Assembler::defineSymbol(const std::string_view &symbol, FixPoint value) {
+  if (symbol.empty()) {
+    return;
   }
+  auto slot = symbolSlots_.getSlot(symbol);
+  if (slot >= slotValues_.size()) {
+    slotValues_.resize(slot + 1);
+  }
+  if (!slotValues_[slot]) {
+    slotValues_[slot] = value;
+  }
+}
+
+[[nodiscard]] addr_t Assembler::getSymbolValue(SymbolSlots::slot_t slot) {
+  if (slot < slotValues_.size() && slotValues_[slot]) {
+    return *slotValues_[slot];
+  }
+  undefinedSymbol(symbolSlots_.getName(slot));
+}
+
+[[nodiscard]] addr_t
+Assembler::getSymbolValue(const std::string_view &symbol) {
+  auto slot = symbolSlots_.findSlot(symbol);
+  if (slot && *slot < slotValues_.size() && slotValues_[*slot]) {
+    return *slotValues_[*slot];
+  }
+  undefinedSymbol(symbol);
+}
+
+void Assembler::undefinedSymbol(const std::string_view &symbol) {
   if (defineLocation_) {
     auto address = defineLocation_.value();
     defineLocation_ = (address + 1) & 077777;
   }
-  throw std::invalid_argument(symbol);
+  throw std::invalid_argument(std::string(symbol));
+}
+
+std::vector<std::pair<std::string_view, FixPoint>>
+Assembler::getSortedSymbolValues() const {
+  std::vector<std::pair<std::string_view, FixPoint>> values;
+  for (SymbolSlots::slot_t slot = 0; slot < slotValues_.size(); ++slot) {
+    if (slotValues_[slot]) {
+      values.emplace_back(symbolSlots_.getName(slot), *slotValues_[slot]);
+    }
+  }
+  std::sort(values.begin(), values.end(),
+            [](auto &lhs, auto &rhs) { return lhs.first < rhs.first; });
+  return values;
 }
 
 addr_t Assembler::evaluate(const Chunk &chunk, const Expr &expr) {
@@ -143,20 +206,18 @@ Assembler::parseFields(const std::string_view &line,
   return operation;
 }
 
-std::map<std::string_view, Assembler::OperationParser>
-    Assembler::operationParsers_{
-        {"ABS", &Abs::unique}, {"BCD", &Bcd::unique}, {"BES", &Bes::unique},
-        {"BSS", &Bss::unique}, {"DEC", &Dec::unique}, {"DEF", &Def::unique},
-        {"END", &End::unique}, {"EQU", &Equ::unique}, {"FUL", &Ful::unique},
-        {"HED", &Hed::unique}, {"LIB", &Lib::unique}, {"OCT", &Oct::unique},
-        {"ORG", &Org::unique}, {"REM", &Rem::unique}, {"REP", &Rep::unique},
-        {"SYN", &Syn::unique}};
+Assembler::OperationParsers Assembler::operationParsers_{
+    {"ABS", &Abs::unique}, {"BCD", &Bcd::unique}, {"BES", &Bes::unique},
+    {"BSS", &Bss::unique}, {"DEC", &Dec::unique}, {"DEF", &Def::unique},
+    {"END", &End::unique}, {"EQU", &Equ::unique}, {"FUL", &Ful::unique},
+    {"HED", &Hed::unique}, {"LIB", &Lib::unique}, {"OCT", &Oct::unique},
+    {"ORG", &Org::unique}, {"REM", &Rem::unique}, {"REP", &Rep::unique},
+    {"SYN", &Syn::unique}};
 
 Assembler::OperationParser
 Assembler::getOperationParser(const std::string_view &operation) {
-  auto it = operationParsers_.find(operation);
-  if (it != operationParsers_.end()) {
-    return it->second;
+  if (auto parser = operationParsers_.find(operation)) {
+    return *parser;
   }
   return &Instruction::unique;
 }
@@ -172,3 +233,26 @@ SAPAssembler::parseLine(const std::string_view &line) {
   return parseFields(line, trim(fieldLocationSymbol(line)),
                      fieldOperation(line), fieldVariableAndComment(line));
 }
+
+SAPDeckFields
+SAPAssembler::extractFields(std::span<const std::string_view> lines) {
+  SAPDeckFields fields;
+  fields.lines.assign(lines.begin(), lines.end());
+  fields.locationSymbols.reserve(lines.size());
+  fields.operations.reserve(lines.size());
+  fields.variablesAndComments.reserve(lines.size());
+  fields.sequences.reserve(lines.size());
+  for (auto &line : lines) {
+    fields.locationSymbols.push_back(trim(fieldLocationSymbol(line)));
+    fields.operations.push_back(fieldOperation(line));
+    fields.variablesAndComments.push_back(fieldVariableAndComment(line));
+    fields.sequences.push_back(fieldSequence(line));
+  }
+  return fields;
+}
+
+std::unique_ptr<Operation> SAPAssembler::parseCard(const SAPDeckFields &fields,
+                                                   size_t pos) {
+  return parseFields(fields.lines[pos], fields.locationSymbols[pos],
+                     fields.operations[pos], fields.variablesAndComments[pos]);
+}
@@ -21,3 +21,49 @@
 // SOFTWARE.
 
 #include "Z0ftware/bcd.hpp"
+
+#include <algorithm>
+
+size_t packBCD(std::span<const bcd_t> bcds, std::span<word_t> words,
+               bcd_t pad) {
+  size_t fullWords = std::min(bcds.size() / bcdPerWord, words.size());
+  const bcd_t *next = bcds.data();
+  // Fixed shifts with no carried state, so the compiler can vectorize
+  for (size_t i = 0; i < fullWords; ++i, next += bcdPerWord) {
+    words[i] = word_t(next[0].value()) << 30 | word_t(next[1].value()) << 24 |
+               word_t(next[2].value()) << 18 | word_t(next[3].value()) << 12 |
+               word_t(next[4].value()) << 6 | word_t(next[5].value());
+  }
+  size_t rest = bcds.size() - fullWords * bcdPerWord;
+  if (fullWords == words.size() || rest == 0) {
+    return fullWords;
+  }
+  word_t word = 0;
+  for (size_t i = 0; i < bcdPerWord; ++i) {
+    word = word << 6 | (i < rest ? next[i] : pad).value();
+  }
+  words[fullWords] = word;
+  return fullWords + 1;
+}
+
+size_t unpackBCD(std::span<const word_t> words, std::span<bcd_t> bcds) {
+  size_t fullWords = std::min(words.size(), bcds.size() / bcdPerWord);
+  bcd_t *next = bcds.data();
+  for (size_t i = 0; i < fullWords; ++i, next += bcdPerWord) {
+    word_t word = words[i];
+    next[0] = word >> 30;
+    next[1] = word >> 24;
+    next[2] = word >> 18;
+    next[3] = word >> 12;
+    next[4] = word >> 6;
+    next[5] = word;
+  }
+  size_t count = fullWords * bcdPerWord;
+  if (fullWords < words.size()) {
+    word_t word = words[fullWords];
+    for (size_t i = 0; count < bcds.size(); ++i) {
+      bcds[count++] = word >> (30 - 6 * i);
+    }
+  }
+  return count;
+}
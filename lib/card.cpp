@@ -22,22 +22,123 @@
 
 #include "Z0ftware/card.hpp"
 #include "Z0ftware/bcd.hpp"
+#include "Z0ftware/charset.hpp"
+#include "Z0ftware/convert.hpp"
 #include "Z0ftware/field.hpp"
 #include "Z0ftware/parity.hpp"
 
 #include <cassert>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 
-SAPDeck::SAPDeck(std::istream &stream) {
-  char cardText[81];
-  while (stream.good()) {
-    stream.getline(cardText, sizeof(cardText));
-    auto count = stream.gcount();
-    if (count == 0) {
-      continue;
+namespace {
+// Reads the rest of input, with one read when the size is known
+std::vector<char> readAll(std::istream &input) {
+  std::vector<char> data;
+  auto start = input.tellg();
+  if (start != std::istream::pos_type(-1) &&
+      input.seekg(0, std::ios::end)) {
+    data.resize(input.tellg() - start);
+    input.seekg(start);
+    input.read(data.data(), data.size());
+    data.resize(input.gcount());
+  } else {
+    input.clear();
+    data.assign(std::istreambuf_iterator<char>(input),
+                std::istreambuf_iterator<char>());
+  }
+  return data;
+}
+} // namespace
+
+SAPDeck::SAPDeck(std::istream &stream) : text_(readAll(stream)) {
+  splitLines();
+}
+
+SAPDeck::SAPDeck(const CardDeck &deck, const NamedCharset &charset) {
+  numSubstituted_ = decodeSourceCards(deck.getCards(), charset, text_);
+  splitLines();
+}
+
+void SAPDeck::splitLines() {
+  cards_.clear();
+  const char *next = text_.data();
+  const char *end = next + text_.size();
+  while (next < end) {
+    auto eol = static_cast<const char *>(std::memchr(next, '\n', end - next));
+    if (!eol) {
+      eol = end;
+    }
+    cards_.emplace_back(next, eol - next);
+    next = eol + 1;
+  }
+}
+
+size_t decodeSourceCards(std::span<const CardImage> cards,
+                         const NamedCharset &charset, std::vector<char> &text) {
+  // SAP fields are byte columns, so any glyph that is not one byte, including
+  // unassigned codes, is replaced with sourceCardSubstitute
+  auto &tapeCharSet = charset.getTapeCharSet();
+  std::array<char, convert_tables::numBCD> glyphs;
+  for (size_t bcd = 0; bcd < glyphs.size(); ++bcd) {
+    auto glyph = tapeCharSet[bcd];
+    glyphs[bcd] = glyph.size() == 1 ? glyph[0] : sourceCardSubstitute;
+  }
+
+  size_t numSubstituted = 0;
+  for (auto &card : cards) {
+    auto &columns = card.getData();
+    size_t end = numCardColumns;
+    while (end > 0 && columns[end - 1] == hollerith()) {
+      --end;
+    }
+    for (size_t column = 0; column < end; ++column) {
+      auto bcd =
+          convert_tables::tapeFromHollerithTable[columns[column].value()];
+      char glyph = glyphs[bcd];
+      if (glyph == sourceCardSubstitute) {
+        ++numSubstituted;
+      }
+      text.push_back(glyph);
+    }
+    text.push_back('\n');
+  }
+  return numSubstituted;
+}
+
+size_t encodeSourceCards(std::span<const std::string_view> lines,
+                         const NamedCharset &charset,
+                         std::vector<CardImage> &cards) {
+  // encode gives a char it cannot encode the code 077, which is only right if
+  // the char is 077's glyph
+  constexpr bcd_t::value_t unknownBCD = 077;
+  auto &tapeCharSet = charset.getTapeCharSet();
+  const utf8_t &unknownGlyph = tapeCharSet[unknownBCD];
+  size_t numUnencodable = 0;
+  std::array<bcd_t, numCardColumns> bcds;
+  for (auto line : lines) {
+    auto &columns = cards.emplace_back().getData();
+    size_t size = tapeCharSet.encode(line, bcds);
+    const char *next = line.data();
+    const char *end = next + line.size();
+    for (size_t column = 0; column < size; ++column) {
+      // Step over the char the same way encode does
+      unicode_char_t c;
+      size_t charSize = decodeUtf8(utf8_string_view_t(next, end - next), c);
+      charSize = charSize ? charSize : 1;
+      if (bcds[column].value() == unknownBCD &&
+          (unknownGlyph == utf8_replacement ||
+           utf8_string_view_t(next, charSize) != unknownGlyph)) {
+        ++numUnencodable;
+      }
+      next += charSize;
+      columns[column] =
+          convert_tables::hollerithFromTapeTable[bcds[column].value()];
     }
-    cards_.emplace_back(std::string_view(cardText, cardText + count - 1));
   }
+  return numUnencodable;
 }
 
 std::ostream &SAPDeck::operator<<(std::ostream &os) const {
@@ -48,35 +149,30 @@ std::ostream &SAPDeck::operator<<(std::ostream &os) const {
 }
 
 void BinaryColumnCard::readCBN(std::istream &input) {
-  std::array<char, 160> buffer;
+  std::array<char, cbnCardSize> buffer;
   input.read(buffer.data(), buffer.size());
   auto count = input.gcount();
   if (count == 0) {
     return;
   }
-  if (count < 160) {
+  if (size_t(count) < cbnCardSize) {
     std::fill(buffer.begin() + count, buffer.end(), 0);
   }
-  size_t i = 0;
-  size_t j = 0;
-  while (i < buffer.size()) {
-    uint8_t b0 = buffer[i++];
-    if (i == 1) {
-      // First byte has bit 7 set
-      assert((b0 & 0x80) != 0);
-      b0 &= 0x7f;
-    }
-    assert(odd_parity_bcd_t(b0) == oddParity(bcd_t(b0)));
-    b0 &= 0x3f;
-    uint8_t b1 = buffer[i++];
-    assert(odd_parity_bcd_t(b1) == oddParity(bcd_t(b1)));
-    b1 &= 0x3f;
-    columns_[j++] = hollerith_t(b0) << 6 | hollerith_t(b1);
-  }
+  decodeCBN(buffer.data(), columns_);
 }
 
 void BinaryColumnCard::fill(const BinaryRowCard &card) {
-  std::fill(columns_.begin(), columns_.end(), 0);
+  // Inverse of BinaryRowCard::fill
+  auto column = columns_.begin();
+  for (int row = 0; row < 12; ++row) {
+    for (int side = 0; side < 2; ++side) {
+      word_t word = card.rowWords_[side][row];
+      *column++ = hollerith_t((word >> 24) & 0xFFF);
+      *column++ = hollerith_t((word >> 12) & 0xFFF);
+      *column++ = hollerith_t(word & 0xFFF);
+    }
+  }
+  std::fill(column, columns_.end(), 0);
 }
 
 void BinaryRowCard::fill(const BinaryColumnCard &card) {
@@ -92,15 +188,16 @@ void BinaryRowCard::fill(const BinaryColumnCard &card) {
   //  9 : 9L12 9L24 9L36 *  0
   //
   // 9L : 1.12 1.11 1.0 ... 1.9 2.12 2.11 2.0 ... 2.9 ... 3.12 3.11 3.0 ... 3.9
-  int startCol = 1;
+  //
+  // Each word is three consecutive 12-bit columns, so no bits move within a
+  // column.
+  auto column = card.getColumns().begin();
   for (int row = 0; row < 12; ++row) {
     for (int side = 0; side < 2; ++side) {
-      word_t &word = rowWords_[side][row];
-      word = 0;
-      for (int col = startCol - 1; col < startCol + 3 - 1; ++col) {
-        word = word << 12 | card.getColumns().at(col).value();
-      }
-      startCol += 3;
+      rowWords_[side][row] = word_t(column[0].value()) << 24 |
+                             word_t(column[1].value()) << 12 |
+                             word_t(column[2].value());
+      column += 3;
     }
   }
 }
@@ -118,6 +215,88 @@ word_t CardImage::getWord(int position) const {
   return result;
 }
 
+namespace {
+// Transposes the 8x8 bit matrix with rows in bytes, most significant first,
+// and columns in bits, most significant first (Hacker's Delight 7-3)
+constexpr uint64_t transpose8(uint64_t x) {
+  uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0;
+  return x ^ t ^ (t << 28);
+}
+
+// A card row of 72 columns is held as 64 + 8 bits, first column most
+// significant
+constexpr unsigned numWordColumns = 72;
+constexpr unsigned numColumnGroups = numWordColumns / 8;
+constexpr word_t wordMask = (word_t(1) << 36) - 1;
+} // namespace
+
+CardImage::words_t CardImage::getWords() const {
+  std::array<uint64_t, numCardRows> rowHigh{0};
+  std::array<uint64_t, numCardRows> rowLow{0};
+  for (unsigned group = 0; group < numColumnGroups; ++group) {
+    // Bits 0-7 and 8-11 of eight columns, first column in the high byte
+    uint64_t low = 0;
+    uint64_t high = 0;
+    for (unsigned column = group * 8; column < group * 8 + 8; ++column) {
+      low = low << 8 | (data_[column].value() & 0xFF);
+      high = high << 8 | (data_[column].value() >> 8);
+    }
+    // Now byte n has bit n of the columns
+    low = transpose8(low);
+    high = transpose8(high);
+    auto &row = (group < 8) ? rowHigh : rowLow;
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      row[bit] = row[bit] << 8 | ((low >> (8 * bit)) & 0xFF);
+    }
+    for (unsigned bit = 0; bit < 4; ++bit) {
+      row[8 + bit] = row[8 + bit] << 8 | ((high >> (8 * bit)) & 0xFF);
+    }
+  }
+
+  words_t words;
+  for (unsigned bit = 0; bit < numCardRows; ++bit) {
+    words[2 * bit] = rowHigh[bit] >> 28;
+    words[2 * bit + 1] = (rowHigh[bit] << 8 | rowLow[bit]) & wordMask;
+  }
+  return words;
+}
+
+void CardImage::setWords(const words_t &words) {
+  std::array<uint64_t, numCardRows> rowHigh;
+  std::array<uint64_t, numCardRows> rowLow;
+  for (unsigned bit = 0; bit < numCardRows; ++bit) {
+    rowHigh[bit] = (words[2 * bit] & wordMask) << 28 |
+                   (words[2 * bit + 1] & wordMask) >> 8;
+    rowLow[bit] = words[2 * bit + 1] & 0xFF;
+  }
+
+  for (unsigned group = 0; group < numColumnGroups; ++group) {
+    // Byte n has bit n of the eight columns
+    uint64_t low = 0;
+    uint64_t high = 0;
+    for (unsigned bit = 0; bit < 12; ++bit) {
+      uint64_t byte = (group < 8) ? (rowHigh[bit] >> (56 - 8 * group)) & 0xFF
+                                  : rowLow[bit];
+      if (bit < 8) {
+        low |= byte << (8 * bit);
+      } else {
+        high |= byte << (8 * (bit - 8));
+      }
+    }
+    low = transpose8(low);
+    high = transpose8(high);
+    for (unsigned i = 0; i < 8; ++i) {
+      unsigned shift = 8 * (7 - i);
+      data_[group * 8 + i] =
+          hollerith_t(((high >> shift) & 0x0F) << 8 | ((low >> shift) & 0xFF));
+    }
+  }
+}
+
 void CardImage::setWord(int position, word_t value) {
   // 0-based row/startColumn
   auto bitpos = position / 2;
@@ -131,48 +310,86 @@ void CardImage::setWord(int position, word_t value) {
   }
 }
 
+void decodeCBN(const char *data, CardImage::data_t &columns) {
+  // First byte has bit 7 set
+  assert((data[0] & 0x80) != 0);
+  for (size_t j = 0; j < numCardColumns; ++j) {
+    uint8_t b0 = frameDecodeTable[uint8_t(data[2 * j])];
+    uint8_t b1 = frameDecodeTable[uint8_t(data[2 * j + 1])];
+    assert((b0 & b1 & frameOddOk) != 0);
+    columns[j] = hollerith_t(b0 & frameValueMask) << 6 |
+                 hollerith_t(b1 & frameValueMask);
+  }
+}
+
 CardImage readCBN(std::istream &input) {
   CardImage cardImage;
-  std::array<char, 160> buffer;
+  std::array<char, cbnCardSize> buffer;
   input.read(buffer.data(), buffer.size());
   auto count = input.gcount();
-  if (count < 160) {
+  if (size_t(count) < cbnCardSize) {
     std::fill(buffer.begin() + count, buffer.end(), 0);
   }
-  size_t i = 0;
-  size_t j = 1;
-  while (i < buffer.size()) {
-    uint8_t b0 = buffer[i++];
-    if (i == 1) {
-      // First byte has bit 7 set
-      assert((b0 & 0x80) != 0);
-      b0 &= 0x7f;
-    }
-    assert(odd_parity_bcd_t(b0) == oddParity(bcd_t(b0)));
-    b0 &= 0x3f;
-    uint8_t b1 = buffer[i++];
-    assert(odd_parity_bcd_t(b1) == oddParity(bcd_t(b1)));
-    b1 &= 0x3f;
-    cardImage[j++] = hollerith_t(b0) << 6 | hollerith_t(b1);
-  }
+  decodeCBN(buffer.data(), cardImage.getData());
   return cardImage;
 }
 
-void writeCBN(std::ostream &output, const CardImage &cardImage) {
-  std::array<char, 160> buffer{0};
-  auto bufferp = &buffer[0];
+CardDeck::CardDeck(std::istream &input) { decode(readAll(input)); }
+
+CardDeck::CardDeck(const std::string &fileName) {
+  std::ifstream input(fileName, std::ifstream::binary | std::ifstream::in);
+  if (!input.is_open()) {
+    throw std::runtime_error("Could not open " + fileName);
+  }
+  *this = CardDeck(input);
+}
+
+void CardDeck::decode(std::span<const char> data) {
+  size_t numFull = data.size() / cbnCardSize;
+  size_t rest = data.size() % cbnCardSize;
+  cards_.resize(numFull + (rest > 0 ? 1 : 0));
+  for (size_t i = 0; i < numFull; ++i) {
+    decodeCBN(&data[i * cbnCardSize], cards_[i].getData());
+  }
+  if (rest > 0) {
+    std::array<char, cbnCardSize> buffer{0};
+    std::copy(data.end() - rest, data.end(), buffer.begin());
+    decodeCBN(buffer.data(), cards_.back().getData());
+  }
+}
+
+void encodeCBN(const CardImage &cardImage, char *data) {
+  char *first = data;
   for (int column = 1; column <= 80; column++) {
-    auto column_value = cardImage[column];
-    // First byte has bit 7 set
-    auto high = bcd_t(ldb<6, 6>(column_value));
-    if (column == 1) {
-      high = evenParity(high) | even_parity_bcd_t(0x80);
-    } else {
-      high = oddParity(high);
-    }
-    *bufferp++ = high.value();
-    auto low = oddParity(bcd_t(ldb<0, 6>(column_value)));
-    *bufferp++ = low.value();
+    auto column_value = cardImage[column].value();
+    *data++ = oddFrameTable[(column_value >> 6) & 0x3F];
+    *data++ = oddFrameTable[column_value & 0x3F];
+  }
+  // First byte has bit 7 set
+  *first |= 0x80;
+}
+
+void writeCBN(std::ostream &output, const CardImage &cardImage) {
+  std::array<char, cbnCardSize> buffer;
+  encodeCBN(cardImage, buffer.data());
+  output.write(buffer.data(), buffer.size());
+}
+
+CardDeckWriter::CardDeckWriter(std::ostream &output, size_t bufferCards)
+    : output_(output),
+      buffer_(std::max<size_t>(bufferCards, 1) * cbnCardSize) {}
+
+void CardDeckWriter::write(const CardImage &cardImage) {
+  if (size_ == buffer_.size()) {
+    flush();
+  }
+  encodeCBN(cardImage, &buffer_[size_]);
+  size_ += cbnCardSize;
+}
+
+void CardDeckWriter::flush() {
+  if (size_ > 0) {
+    output_.write(buffer_.data(), size_);
+    size_ = 0;
   }
-  output.write(buffer.data(), 160);
 }
@@ -21,8 +21,13 @@
 // SOFTWARE.
 
 #include "Z0ftware/charset.hpp"
+#include "Z0ftware/convert.hpp"
 #include "Z0ftware/unicode.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
 // https://bitsavers.org/pdf/ibm/702/22-6173-1_702prelim_Feb56.pdf page 76
 // 11-0 -> 0- 2A (Prints &) (pg 79)
 // 12-0 -> 0+ 3A (Prints -) (pg 79)
@@ -104,6 +109,22 @@ CollateGlyphCardTape collateGlyphCardTape(CollateGlyphCardTape::items_t(
      {62, {"8"}, hollerith(8), 0x08},
      {63, {"9"}, hollerith(9), 0x09}}));
 
+namespace {
+// The codes with odd parity could be a one bit error for any of the adjacent
+// bits
+void addParityErrorGlyphs(parity_glyphs_t &charset) {
+  for (tape_bcd_t i = 0; i < (1 << tape_bcd_t::bit_size()); ++i) {
+    odd_parity_bcd_t odd = oddParity(i);
+    std::string glyphs = "{";
+    for (uint8_t bitpos = 0; bitpos < odd_parity_bcd_t::bit_size(); ++bitpos) {
+      even_parity_bcd_t even = odd.value() ^ (1 << bitpos);
+      glyphs += charset.at(even.value());
+    }
+    charset.at(odd.value()) = glyphs + "}";
+  }
+}
+} // namespace
+
 std::unique_ptr<parity_glyphs_t> CollateGlyphCardTape::getTapeCharset(bool alternate) const {
   auto charset = std::make_unique<parity_glyphs_t>();
   // Fill in the glyphs for even parity
@@ -111,20 +132,168 @@ std::unique_ptr<parity_glyphs_t> CollateGlyphCardTape::getTapeCharset(bool alter
     even_parity_bcd_t even = evenParity(item.sc);
     charset->at(even.value()) = item.glyphs[alternate ? (item.glyphs.size() - 1) : 0].getUtf8Char();
   }
-  // The codes with odd parity could be a one bit error for any of the adjacent
-  // bits
+  addParityErrorGlyphs(*charset);
+  return charset;
+}
+
+std::unique_ptr<parity_glyphs_t>
+BCDCharSetForTape::getTapeCharset(bool /*alternate*/) const {
+  auto charset = std::make_unique<parity_glyphs_t>();
+  BCDCharSet::charmap_t tapeChars;
+  charSet_.initTapeChars(tapeChars);
   for (tape_bcd_t i = 0; i < (1 << tape_bcd_t::bit_size()); ++i) {
-    odd_parity_bcd_t odd = oddParity(i);
-    std::string glyphs = "{";
-    for (uint8_t bitpos = 0; bitpos < odd_parity_bcd_t::bit_size(); ++bitpos) {
-      even_parity_bcd_t even = odd.value() ^ (1 << bitpos);
-      glyphs += charset->at(even.value());
-    }
-    charset->at(odd.value()) = glyphs + "}";
+    charset->at(evenParity(i).value()) = tapeChars[i.value()];
   }
+  addParityErrorGlyphs(*charset);
   return charset;
 }
 
+void addToHistogram(bcd_histogram_t &histogram, std::span<const char> frames) {
+  // Four partial histograms so consecutive equal frames do not wait on each
+  // other's increments
+  std::array<std::array<uint32_t, 64>, 4> partial{};
+  size_t i = 0;
+  while (i < frames.size()) {
+    size_t end = std::min(frames.size(), i + (size_t(1) << 30));
+    for (; i + 4 <= end; i += 4) {
+      partial[0][frames[i] & 0x3F]++;
+      partial[1][frames[i + 1] & 0x3F]++;
+      partial[2][frames[i + 2] & 0x3F]++;
+      partial[3][frames[i + 3] & 0x3F]++;
+    }
+    for (; i < end; ++i) {
+      partial[0][frames[i] & 0x3F]++;
+    }
+    for (auto &counts : partial) {
+      for (size_t bcd = 0; bcd < counts.size(); ++bcd) {
+        histogram[bcd] += counts[bcd];
+      }
+      counts.fill(0);
+    }
+  }
+}
+
+namespace {
+int glyphWeight(const utf8_t &glyph) {
+  unicode_char_t c = get_unicode_char(glyph);
+  if (c == unicode_replacement_char) {
+    return -8;
+  }
+  if (c == ' ') {
+    return 3;
+  }
+  if (('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') ||
+      utf8_string_view_t("+-*/=().,$'").find(char(c)) !=
+          utf8_string_view_t::npos) {
+    return 1;
+  }
+  return c < 0x80 ? -1 : -3;
+}
+} // namespace
+
+int64_t scoreTapeCharset(const bcd_histogram_t &histogram,
+                         const parity_glyphs_t &glyphs) {
+  int64_t score = 0;
+  for (tape_bcd_t i = 0; i < (1 << tape_bcd_t::bit_size()); ++i) {
+    if (histogram[i.value()] != 0) {
+      score += int64_t(histogram[i.value()]) *
+               glyphWeight(glyphs.at(evenParity(i).value()));
+    }
+  }
+  return score;
+}
+
+size_t detectTapeCharset(const bcd_histogram_t &histogram,
+                         std::span<const parity_glyphs_t *const> candidates) {
+  size_t best = 0;
+  int64_t bestScore = std::numeric_limits<int64_t>::min();
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    int64_t score = scoreTapeCharset(histogram, *candidates[i]);
+    if (score > bestScore) {
+      best = i;
+      bestScore = score;
+    }
+  }
+  return best;
+}
+
+GlyphTranscoder::GlyphTranscoder(const parity_glyphs_t &glyphs) {
+  for (size_t frame = 0; frame < entries_.size(); ++frame) {
+    auto &glyph = glyphs.at(frame);
+    auto &entry = entries_[frame];
+    entry.slot.fill(0);
+    entry.size = glyph.size();
+    entry.poolPos = 0;
+    if (glyph.size() <= slotSize) {
+      std::copy(glyph.begin(), glyph.end(), entry.slot.begin());
+    } else {
+      entry.poolPos = pool_.size();
+      pool_ += glyph;
+      maxSize_ = std::max(maxSize_, glyph.size());
+    }
+  }
+}
+
+void GlyphTranscoder::transcode(std::span<const char> frames,
+                                std::string &output) const {
+  size_t start = output.size();
+  // Room for whole slots, trimmed when done
+  output.resize(start + frames.size() * maxSize_);
+  char *next = output.data() + start;
+  for (char frame : frames) {
+    auto &entry = entries_[frame & 0x7F];
+    if (entry.size <= slotSize) {
+      std::copy(entry.slot.begin(), entry.slot.end(), next);
+    } else {
+      std::copy_n(pool_.data() + entry.poolPos, entry.size, next);
+    }
+    next += entry.size;
+  }
+  output.resize(next - output.data());
+}
+
+void BCDCharSet::hashWide(const std::vector<WideEntry> &wide) {
+  std::vector<WideEntry> entries;
+  for (auto it = wide.rbegin(); it != wide.rend(); ++it) {
+    if (std::none_of(entries.begin(), entries.end(), [&it](auto &entry) {
+          return entry.unicode == it->unicode;
+        })) {
+      entries.push_back(*it);
+    }
+  }
+
+  // Unicode chars are less than 2^21
+  std::vector<uint32_t> keys;
+  for (auto &entry : entries) {
+    keys.push_back(entry.unicode);
+  }
+  wideHash_ = findPerfectHash(keys, 21);
+  wideBCD_.assign(wideHash_.size(), WideEntry());
+  for (auto &entry : entries) {
+    wideBCD_[wideHash_(entry.unicode)] = entry;
+  }
+}
+
+size_t BCDCharSet::encode(utf8_string_view_t text,
+                          std::span<bcd_t> bcds) const {
+  size_t count = 0;
+  const char *next = text.data();
+  const char *end = next + text.size();
+  while (next < end && count < bcds.size()) {
+    unsigned char c0 = *next;
+    if (c0 < asciiBCD_.size()) {
+      bcds[count++] = asciiBCD_[c0];
+      ++next;
+      continue;
+    }
+    unicode_char_t c;
+    size_t size = decodeUtf8(utf8_string_view_t(next, end - next), c);
+    bcds[count++] = getWideBCD(c);
+    next += size ? size : 1;
+  }
+  return count;
+}
+
 // https://bitsavers.org/pdf/ibm/punchedCard/Keypunch/029/A24-3332-3_29_Reference_Man.pdf
 CardGlyph IBM029[] = {{hollerith(), " "},
                       //
@@ -717,7 +886,7 @@ void TapeBCDCharSet::initCPUChars(charmap_t &cpuChars) const {
   std::fill(cpuChars.begin(), cpuChars.end(), utf8_replacement);
   for (tape_bcd_t tapeBCD = tape_bcd_t::min(); tapeBCD <= tape_bcd_t::max();
        tapeBCD++) {
-    cpu704_bcd_t cpuBCD = cpu704_bcd_t(tapeBCD);
+    cpu704_bcd_t cpuBCD = convert<cpu704_bcd_t>(tapeBCD);
     auto &c = charMap_[tapeBCD.value()];
     if (c != utf8_replacement) {
       cpuChars[cpuBCD.value()] = c;
@@ -741,7 +910,7 @@ void IBM704BCDCharSet::initTapeChars(charmap_t &tapeChars) const {
       // Remapped to space
       continue;
     }
-    tape_bcd_t tapeBCD = tape_bcd_t(cpuBCD);
+    tape_bcd_t tapeBCD = convert<tape_bcd_t>(cpuBCD);
     auto &c = charMap_[cpuBCD.value()];
     if (c != utf8_replacement) {
       tapeChars[tapeBCD.value()] = c;
@@ -786,12 +955,11 @@ BCD_ASCII mapTape[] = {
 /// Convert first 6 ASCII chars to big-endian bcd chars
 /// If less than 6, pad right with spaces
 uint64_t bcd(utf8_string_view_t chars) {
-  int count = 0;
+  std::array<bcd_t, 6> bcds;
+  size_t count = BCDSherman.encode(chars, bcds);
   std::uint64_t result = 0;
-  while (count < 6 && !chars.empty()) {
-    result =
-        (result << 6) | BCDSherman.getCPUBCD(get_next_utf8_char(chars)).value();
-    count++;
+  for (size_t i = 0; i < count; ++i) {
+    result = (result << 6) | bcds[i].value();
   }
   return result;
 }
@@ -1131,3 +1299,210 @@ const std::vector<HollerithChar> &getBCD702() {
       {hollerith(4, 8), '@'}});
   return table;
 }
+
+struct NamedCharset::Tables {
+  Tables(const std::string &description,
+         const BCDCharSet::charmap_t &tapeChars,
+         const std::vector<HollerithChar> &hollerithChars);
+
+  parity_glyphs_t tapeGlyphs;
+  GlyphTranscoder tapeTranscoder;
+  TapeBCDCharSet tapeCharSet;
+  IBM704BCDCharSet cpuCharSet;
+  // Index into hollerithGlyphs for each column; 0 is the replacement char
+  std::array<uint8_t, 1 << hollerith_t::bit_size()> hollerithIndex{};
+  std::vector<utf8_t> hollerithGlyphs{utf8_replacement};
+  std::unordered_map<unicode_char_t, hollerith_t::value_t>
+      hollerithFromUnicode;
+};
+
+namespace {
+parity_glyphs_t getParityGlyphs(const BCDCharSet::charmap_t &tapeChars) {
+  parity_glyphs_t glyphs;
+  for (tape_bcd_t i = 0; i < (1 << tape_bcd_t::bit_size()); ++i) {
+    glyphs.at(evenParity(i).value()) = tapeChars[i.value()];
+  }
+  addParityErrorGlyphs(glyphs);
+  return glyphs;
+}
+
+BCDCharSet::charmap_t getCPUChars(const TapeBCDCharSet &tapeCharSet) {
+  BCDCharSet::charmap_t cpuChars;
+  tapeCharSet.initCPUChars(cpuChars);
+  return cpuChars;
+}
+
+utf8_t getGlyph(const HollerithChar &hollerithChar) {
+  return hollerithChar.utf8_.empty() ? get_utf8_char(hollerithChar.unicode)
+                                     : hollerithChar.utf8_;
+}
+} // namespace
+
+NamedCharset::Tables::Tables(const std::string &description,
+                             const BCDCharSet::charmap_t &tapeChars,
+                             const std::vector<HollerithChar> &hollerithChars)
+    : tapeGlyphs(getParityGlyphs(tapeChars)), tapeTranscoder(tapeGlyphs),
+      tapeCharSet(description, tapeChars),
+      cpuCharSet(description, getCPUChars(tapeCharSet)) {
+  for (auto &hollerithChar : hollerithChars) {
+    auto &index = hollerithIndex[hollerithChar.column.value()];
+    if (index == 0) {
+      index = hollerithGlyphs.size();
+      hollerithGlyphs.push_back(getGlyph(hollerithChar));
+      hollerithFromUnicode.emplace(get_unicode_char(hollerithGlyphs.back()),
+                                   hollerithChar.column.value());
+    }
+  }
+}
+
+NamedCharset::NamedCharset(std::string name, std::string description,
+                           tape_chars_t tapeChars,
+                           hollerith_chars_t hollerithChars)
+    : name_(std::move(name)), description_(std::move(description)),
+      tapeChars_(std::move(tapeChars)),
+      hollerithChars_(std::move(hollerithChars)) {}
+
+NamedCharset::~NamedCharset() = default;
+
+const NamedCharset::Tables &NamedCharset::getTables() const {
+  std::call_once(tablesOnce_, [this]() {
+    BCDCharSet::charmap_t tapeChars = tapeChars_();
+    std::vector<HollerithChar> hollerithChars;
+    if (hollerithChars_) {
+      hollerithChars = hollerithChars_();
+    } else {
+      for (tape_bcd_t i = 1; i < (1 << tape_bcd_t::bit_size()); ++i) {
+        auto &glyph = tapeChars[i.value()];
+        if (!glyph.empty() && glyph != utf8_replacement) {
+          hollerithChars.emplace_back(convert<hollerith_t>(i), glyph);
+        }
+      }
+    }
+    tables_ =
+        std::make_unique<Tables>(description_, tapeChars, hollerithChars);
+  });
+  return *tables_;
+}
+
+const parity_glyphs_t &NamedCharset::getTapeGlyphs() const {
+  return getTables().tapeGlyphs;
+}
+
+const GlyphTranscoder &NamedCharset::getTapeTranscoder() const {
+  return getTables().tapeTranscoder;
+}
+
+const BCDCharSet &NamedCharset::getTapeCharSet() const {
+  return getTables().tapeCharSet;
+}
+
+const BCDCharSet &NamedCharset::getCPUCharSet() const {
+  return getTables().cpuCharSet;
+}
+
+utf8_string_view_t NamedCharset::getHollerithGlyph(hollerith_t column) const {
+  auto &tables = getTables();
+  return tables.hollerithGlyphs[tables.hollerithIndex[column.value()]];
+}
+
+std::optional<hollerith_t> NamedCharset::getHollerith(unicode_char_t c) const {
+  auto &tables = getTables();
+  auto it = tables.hollerithFromUnicode.find(c);
+  if (it == tables.hollerithFromUnicode.end()) {
+    return std::nullopt;
+  }
+  return hollerith_t(it->second);
+}
+
+namespace {
+NamedCharset::tape_chars_t
+tapeCharsFromCollated(const CharsetForTape &charset, bool alternate) {
+  return [&charset, alternate]() {
+    auto glyphs = charset.getTapeCharset(alternate);
+    BCDCharSet::charmap_t tapeChars;
+    for (tape_bcd_t i = 0; i < (1 << tape_bcd_t::bit_size()); ++i) {
+      tapeChars[i.value()] = glyphs->at(evenParity(i).value());
+    }
+    return tapeChars;
+  };
+}
+
+NamedCharset::tape_chars_t tapeCharsFromBCD(const BCDCharSet &charSet) {
+  return [&charSet]() {
+    BCDCharSet::charmap_t tapeChars;
+    charSet.initTapeChars(tapeChars);
+    return tapeChars;
+  };
+}
+
+// Columns that round trip through tape BCD; the first glyph for a column wins
+NamedCharset::tape_chars_t tapeCharsFromHollerith(
+    const std::vector<HollerithChar> &(*hollerithChars)()) {
+  return [hollerithChars]() {
+    BCDCharSet::charmap_t tapeChars;
+    tapeChars.fill(utf8_replacement);
+    for (auto &hollerithChar : hollerithChars()) {
+      tape_bcd_t tapeBCD = convert<tape_bcd_t>(hollerithChar.column);
+      if (convert<hollerith_t>(tapeBCD) == hollerithChar.column &&
+          tapeChars[tapeBCD.value()] == utf8_replacement) {
+        tapeChars[tapeBCD.value()] = getGlyph(hollerithChar);
+      }
+    }
+    return tapeChars;
+  };
+}
+} // namespace
+
+const std::deque<NamedCharset> &getNamedCharsets() {
+  static std::deque<NamedCharset> charsets = []() {
+    std::deque<NamedCharset> charsets;
+    charsets.emplace_back("collated", "SHARE tape collated glyphs",
+                          tapeCharsFromCollated(collateGlyphCardTape, true));
+    charsets.emplace_back("collated-primary",
+                          "SHARE tape collated glyphs, primary choices",
+                          tapeCharsFromCollated(collateGlyphCardTape, false));
+    auto addBCD = [&charsets](std::string name, const BCDCharSet &charSet) {
+      charsets.emplace_back(std::move(name), charSet.getDescription(),
+                            tapeCharsFromBCD(charSet));
+    };
+    addBCD("bcdic-a", BCDIC_A);
+    addBCD("bcdic-b", BCDIC_B);
+    addBCD("bcdic-final-a", BCDICFinal_A);
+    addBCD("bcdic-final-b", BCDICFinal_B);
+    addBCD("704", BCD704);
+    addBCD("716g", BCD716G);
+    addBCD("716-fortran", BCD716Fortran);
+    addBCD("7090", BCDIBM7090);
+    addBCD("sherman", BCDSherman);
+    auto addHollerith = [&charsets](std::string name, std::string description,
+                                    const std::vector<HollerithChar> &(
+                                        *hollerithChars)()) {
+      charsets.emplace_back(
+          std::move(name), std::move(description),
+          tapeCharsFromHollerith(hollerithChars),
+          [hollerithChars]() { return hollerithChars(); });
+    };
+    addHollerith("026-commercial", "026 commercial keypunch",
+                 get026CommercialEncoding);
+    addHollerith("029", "029 keypunch", get029Encoding);
+    addHollerith("fap", "FAP", getFAPEncoding);
+    addHollerith("fortran-704", "704 FORTRAN", getFORTRAN704Encoding);
+    addHollerith("fortran-704-4", "704 FORTRAN, alternate 4-8",
+                 getFORTRAN704Encoding4);
+    addHollerith("fortran-iv", "FORTRAN IV", getFORTRANIVEncoding);
+    addHollerith("bcdic-1", "BCDIC 1", getBCDIC1);
+    addHollerith("bcdic-2", "BCDIC 2", getBCDIC2);
+    addHollerith("702", "IBM 702/705/650", getBCD702);
+    return charsets;
+  }();
+  return charsets;
+}
+
+const NamedCharset *findNamedCharset(std::string_view name) {
+  for (auto &charset : getNamedCharsets()) {
+    if (charset.getName() == name) {
+      return &charset;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,365 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/decimal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+
+namespace {
+// Limits that keep BigUint in bounds
+constexpr size_t maxDigits = 400;
+constexpr int maxPow10 = 400;
+
+constexpr std::array<uint32_t, 10> pow10{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// An unsigned integer large enough for maxDigits scaled by 10^maxPow10 and a
+// binary shift, without allocation
+class BigUint {
+public:
+  BigUint(__uint128_t value = 0) {
+    for (; value != 0; value >>= 32) {
+      limbs_[size_++] = uint32_t(value);
+    }
+  }
+
+  bool isZero() const { return size_ == 0; }
+
+  // Only valid if bitWidth() <= 128
+  __uint128_t toUint128() const {
+    __uint128_t value = 0;
+    for (size_t i = size_; i-- > 0;) {
+      value = value << 32 | limbs_[i];
+    }
+    return value;
+  }
+
+  size_t bitWidth() const {
+    return size_ == 0 ? 0
+                      : 32 * (size_ - 1) + std::bit_width(limbs_[size_ - 1]);
+  }
+
+  // *this = *this * multiplier + addend
+  void mulAdd(uint32_t multiplier, uint32_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < size_; ++i) {
+      carry += uint64_t(limbs_[i]) * multiplier;
+      limbs_[i] = uint32_t(carry);
+      carry >>= 32;
+    }
+    if (carry) {
+      assert(size_ < maxLimbs);
+      limbs_[size_++] = uint32_t(carry);
+    }
+  }
+
+  void mulPow10(unsigned n) {
+    for (; n >= 9; n -= 9) {
+      mulAdd(pow10[9], 0);
+    }
+    mulAdd(pow10[n], 0);
+  }
+
+  void shiftLeft(size_t bits) {
+    if (size_ == 0 || bits == 0) {
+      return;
+    }
+    size_t limbShift = bits / 32;
+    unsigned bitShift = bits % 32;
+    assert(size_ + limbShift + 1 <= maxLimbs);
+    limbs_[size_ + limbShift] = 0;
+    for (size_t i = size_; i-- > 0;) {
+      uint64_t limb = uint64_t(limbs_[i]) << bitShift;
+      limbs_[i + limbShift + 1] |= uint32_t(limb >> 32);
+      limbs_[i + limbShift] = uint32_t(limb);
+    }
+    std::fill_n(limbs_.begin(), limbShift, 0);
+    size_ += limbShift + 1;
+    trim();
+  }
+
+  void shiftRight1() {
+    for (size_t i = 0; i < size_; ++i) {
+      limbs_[i] = limbs_[i] >> 1 | (i + 1 < size_ ? limbs_[i + 1] << 31 : 0);
+    }
+    trim();
+  }
+
+  // Requires other <= *this
+  void subtract(const BigUint &other) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      int64_t difference = int64_t(limbs_[i]) - borrow -
+                           (i < other.size_ ? int64_t(other.limbs_[i]) : 0);
+      borrow = difference < 0;
+      limbs_[i] = uint32_t(difference);
+    }
+    trim();
+  }
+
+  friend bool operator<=(const BigUint &lhs, const BigUint &rhs) {
+    if (lhs.size_ != rhs.size_) {
+      return lhs.size_ < rhs.size_;
+    }
+    for (size_t i = lhs.size_; i-- > 0;) {
+      if (lhs.limbs_[i] != rhs.limbs_[i]) {
+        return lhs.limbs_[i] < rhs.limbs_[i];
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr size_t maxLimbs = 96;
+
+  void trim() {
+    while (size_ > 0 && limbs_[size_ - 1] == 0) {
+      --size_;
+    }
+  }
+
+  std::array<uint32_t, maxLimbs> limbs_;
+  size_t size_{0};
+};
+
+// Returns the quotient, which must be less than 2^64, and leaves the remainder
+// in numerator
+uint64_t divide(BigUint &numerator, const BigUint &denominator) {
+  if (!(denominator <= numerator)) {
+    return 0;
+  }
+  if (numerator.bitWidth() <= 128) {
+    // Most DEC numbers are small
+    __uint128_t n = numerator.toUint128();
+    __uint128_t d = denominator.toUint128();
+    numerator = BigUint(n % d);
+    return uint64_t(n / d);
+  }
+  size_t shift = numerator.bitWidth() - denominator.bitWidth();
+  assert(shift < 64);
+  BigUint shifted = denominator;
+  shifted.shiftLeft(shift);
+  uint64_t quotient = 0;
+  for (size_t bit = shift + 1; bit-- > 0;) {
+    if (shifted <= numerator) {
+      numerator.subtract(shifted);
+      quotient |= uint64_t(1) << bit;
+    }
+    shifted.shiftRight1();
+  }
+  return quotient;
+}
+
+// Appends the digits at next to value, from_chars a limb at a time. If there
+// are more than limit digits, they are skipped and value is unchanged.
+size_t scanDigits(const char *&next, const char *end, BigUint &value,
+                  size_t limit) {
+  const char *digitsEnd =
+      std::find_if(next, end, [](char c) { return c < '0' || '9' < c; });
+  size_t count = digitsEnd - next;
+  if (count > limit) {
+    next = digitsEnd;
+    return count;
+  }
+  while (next < digitsEnd) {
+    size_t chunk = std::min<size_t>(digitsEnd - next, 9);
+    uint32_t limb = 0;
+    std::from_chars(next, next + chunk, limb);
+    value.mulAdd(pow10[chunk], limb);
+    next += chunk;
+  }
+  return count;
+}
+
+// digits * 10^pow10Exp as a Float, 1/2 <= mantissa < 1
+std::optional<Word> toFloat(bool negative, const BigUint &digits,
+                            int pow10Exp) {
+  using Mantissa = Float::MANTISSA;
+  if (digits.isZero()) {
+    return Float(negative, 0, 0);
+  }
+  BigUint numerator = digits;
+  BigUint denominator{1};
+  if (pow10Exp >= 0) {
+    numerator.mulPow10(pow10Exp);
+  } else {
+    denominator.mulPow10(-pow10Exp);
+  }
+  // Scale so the quotient has Mantissa::bit_size + 1 or + 2 bits
+  int scale = int(Mantissa::bit_size + 1) -
+              (int(numerator.bitWidth()) - int(denominator.bitWidth()));
+  if (scale > 0) {
+    numerator.shiftLeft(scale);
+  } else {
+    denominator.shiftLeft(-scale);
+  }
+  uint64_t quotient = divide(numerator, denominator);
+  int extra = std::bit_width(quotient) - Mantissa::bit_size;
+  uint64_t mantissa = quotient >> extra;
+  uint64_t rest = quotient & ((uint64_t(1) << extra) - 1);
+  uint64_t half = uint64_t(1) << (extra - 1);
+  if (rest > half ||
+      (rest == half && (!numerator.isZero() || (mantissa & 1) != 0))) {
+    ++mantissa;
+  }
+  int exponent = Mantissa::bit_size + extra - scale;
+  if (mantissa >> Mantissa::bit_size) {
+    mantissa >>= 1;
+    ++exponent;
+  }
+  if (exponent < -int(Float::exp_bias) || exponent >= int(Float::exp_bias)) {
+    return std::nullopt;
+  }
+  return Float(negative, exponent, mantissa);
+}
+
+// digits * 10^pow10Exp * 2^binaryScale, truncated, as a FixPoint
+std::optional<Word> toFixPoint(bool negative, const BigUint &digits,
+                               int pow10Exp, int binaryScale) {
+  using Magnitude = Word::F_MAGNITUDE;
+  BigUint numerator = digits;
+  BigUint denominator{1};
+  if (pow10Exp >= 0) {
+    numerator.mulPow10(pow10Exp);
+  } else {
+    denominator.mulPow10(-pow10Exp);
+  }
+  if (binaryScale >= 0) {
+    numerator.shiftLeft(binaryScale);
+  } else {
+    denominator.shiftLeft(-binaryScale);
+  }
+  if (numerator.bitWidth() > denominator.bitWidth() + Magnitude::bit_size) {
+    return std::nullopt;
+  }
+  uint64_t magnitude = divide(numerator, denominator);
+  if (magnitude >> Magnitude::bit_size) {
+    return std::nullopt;
+  }
+  return FixPoint(negative, magnitude);
+}
+} // namespace
+
+std::optional<Word> parseDecimal(const char *&next, const char *end) {
+  const char *pos = next;
+  bool negative = false;
+  if (pos < end && (*pos == '+' || *pos == '-')) {
+    negative = *pos++ == '-';
+  }
+
+  BigUint digits;
+  size_t numDigits = scanDigits(pos, end, digits, maxDigits);
+  if (numDigits > maxDigits) {
+    return std::nullopt;
+  }
+  size_t numFractionDigits = 0;
+  bool point = pos < end && *pos == '.';
+  if (point) {
+    ++pos;
+    numFractionDigits = scanDigits(pos, end, digits, maxDigits - numDigits);
+  }
+  if (numDigits + numFractionDigits == 0 ||
+      numDigits + numFractionDigits > maxDigits) {
+    return std::nullopt;
+  }
+
+  std::optional<int> exp;
+  std::optional<int> bexp;
+  while (pos < end) {
+    if (*pos == 'E' && !exp) {
+      ++pos;
+      bool negativeExp = pos < end && *pos == '-';
+      if (pos < end && (*pos == '+' || *pos == '-')) {
+        ++pos;
+      }
+      int value = 0;
+      auto [ptr, ec] = std::from_chars(pos, end, value);
+      if (ec != std::errc() || (pos < end && *pos == '-')) {
+        return std::nullopt;
+      }
+      pos = ptr;
+      exp = negativeExp ? -value : value;
+    } else if (*pos == 'B' && !bexp) {
+      ++pos;
+      int value = 0;
+      auto [ptr, ec] =
+          std::from_chars(pos, std::min(pos + 2, end), value);
+      if (ec != std::errc() || (pos < end && *pos == '-')) {
+        return std::nullopt;
+      }
+      pos = ptr;
+      bexp = value;
+    } else {
+      break;
+    }
+  }
+
+  // In 64 bits, since exp can be any int
+  int64_t pow10Exp = int64_t(exp.value_or(0)) - int64_t(numFractionDigits);
+  if (pow10Exp < -maxPow10 || pow10Exp > maxPow10) {
+    if (digits.isZero()) {
+      pow10Exp = 0;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<Word> result;
+  if (!bexp && (point || exp)) {
+    result = toFloat(negative, digits, int(pow10Exp));
+  } else {
+    result = toFixPoint(negative, digits, int(pow10Exp),
+                        bexp ? int(Word::F_SIGN::bit_pos) - *bexp : 0);
+  }
+  if (result) {
+    next = pos;
+  }
+  return result;
+}
+
+bool parseDEC(std::string_view text, std::vector<Word> &values) {
+  const char *next = text.data();
+  const char *end = next + text.size();
+  std::vector<Word> result;
+  while (true) {
+    auto value = parseDecimal(next, end);
+    if (!value) {
+      return false;
+    }
+    result.push_back(*value);
+    if (next < end && *next == ',') {
+      ++next;
+    } else {
+      break;
+    }
+  }
+  if (next < end && *next != ' ') {
+    return false;
+  }
+  values = std::move(result);
+  return true;
+}
@@ -0,0 +1,162 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/editlist.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+EditList::EditList(const std::string &fileName) {
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open " + fileName);
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error(fileName + " is not an edit list");
+  }
+  mapSize_ = st.st_size;
+  map_ = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    throw std::runtime_error("Could not map " + fileName);
+  }
+
+  auto base = static_cast<const char *>(map_);
+  auto header = reinterpret_cast<const Header *>(base);
+  // Counts are checked before they are multiplied so a bad header cannot wrap
+  size_t available = mapSize_ - sizeof(Header);
+  size_t maxEntries = available / sizeof(Entry);
+  bool valid = 0 == std::memcmp(header->magic, magic, sizeof(magic)) &&
+               header->numOffsetEdits <= maxEntries &&
+               header->numRecordOffsetEdits <=
+                   maxEntries - header->numOffsetEdits;
+  // The editors merge entries in order and take their replacements unchecked
+  auto validEntries = [this](std::span<const Entry> edits) {
+    auto key = [](const Entry &entry) {
+      return std::make_tuple(entry.recordNum, entry.begin, entry.end);
+    };
+    for (size_t i = 0; i < edits.size(); ++i) {
+      auto &entry = edits[i];
+      if (entry.replacementPos > replacements_.size() ||
+          entry.replacementSize >
+              replacements_.size() - entry.replacementPos ||
+          (i > 0 && key(entry) < key(edits[i - 1]))) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (valid) {
+    size_t entriesSize =
+        (header->numOffsetEdits + header->numRecordOffsetEdits) *
+        sizeof(Entry);
+    valid = header->replacementsSize <= available - entriesSize;
+    if (valid) {
+      auto entries = reinterpret_cast<const Entry *>(base + sizeof(Header));
+      offsetEdits_ = {entries, header->numOffsetEdits};
+      recordOffsetEdits_ = {entries + header->numOffsetEdits,
+                            header->numRecordOffsetEdits};
+      replacements_ = {base + sizeof(Header) + entriesSize,
+                       header->replacementsSize};
+      valid = validEntries(offsetEdits_) && validEntries(recordOffsetEdits_);
+    }
+  }
+  if (!valid) {
+    munmap(map_, mapSize_);
+    map_ = nullptr;
+    throw std::runtime_error(fileName + " is not an edit list");
+  }
+}
+
+EditList::~EditList() {
+  if (map_) {
+    munmap(map_, mapSize_);
+  }
+}
+
+bool EditList::isEditList(const std::string &fileName) {
+  std::ifstream input(fileName, std::ifstream::binary | std::ifstream::in);
+  char buffer[sizeof(magic)];
+  input.read(buffer, sizeof(buffer));
+  return input.gcount() == sizeof(magic) &&
+         0 == std::memcmp(buffer, magic, sizeof(magic));
+}
+
+void EditList::Writer::addEdit(int64_t begin, int64_t end,
+                               std::string_view replacement) {
+  addEdit(0, begin, end, replacement);
+  offsetEdits_.push_back(recordOffsetEdits_.back());
+  recordOffsetEdits_.pop_back();
+}
+
+void EditList::Writer::addEdit(uint64_t recordNum, int64_t begin, int64_t end,
+                               std::string_view replacement) {
+  recordOffsetEdits_.push_back({.recordNum = recordNum,
+                                .begin = begin,
+                                .end = end,
+                                .replacementPos = replacements_.size(),
+                                .replacementSize = replacement.size()});
+  replacements_.append(replacement);
+}
+
+void EditList::Writer::write(std::ostream &os) {
+  // Same order as the editors' sets, where the first of equal edits wins
+  auto key = [](const Entry &entry) {
+    return std::make_tuple(entry.recordNum, entry.begin, entry.end);
+  };
+  auto sortEdits = [&key](std::vector<Entry> &edits) {
+    std::stable_sort(edits.begin(), edits.end(),
+                     [&key](const Entry &e1, const Entry &e2) {
+                       return key(e1) < key(e2);
+                     });
+    edits.erase(std::unique(edits.begin(), edits.end(),
+                            [&key](const Entry &e1, const Entry &e2) {
+                              return key(e1) == key(e2);
+                            }),
+                edits.end());
+  };
+  sortEdits(offsetEdits_);
+  sortEdits(recordOffsetEdits_);
+
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.numOffsetEdits = offsetEdits_.size();
+  header.numRecordOffsetEdits = recordOffsetEdits_.size();
+  header.replacementsSize = replacements_.size();
+  os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char *>(offsetEdits_.data()),
+           offsetEdits_.size() * sizeof(Entry));
+  os.write(reinterpret_cast<const char *>(recordOffsetEdits_.data()),
+           recordOffsetEdits_.size() * sizeof(Entry));
+  os.write(replacements_.data(), replacements_.size());
+}
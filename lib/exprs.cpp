@@ -22,6 +22,60 @@
 
 #include "Z0ftware/exprs.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+
+SymbolSlots::slot_t SymbolSlots::getSlot(std::string_view name) {
+  if (2 * (names_.size() + 1) > table_.size()) {
+    grow();
+  }
+  size_t hash = std::hash<std::string_view>()(name);
+  size_t pos = probe(name, hash);
+  if (table_[pos] == emptySlot) {
+    table_[pos] = slot_t(names_.size());
+    names_.emplace_back(name);
+    hashes_.push_back(hash);
+  }
+  return table_[pos];
+}
+
+std::optional<SymbolSlots::slot_t>
+SymbolSlots::findSlot(std::string_view name) const {
+  if (table_.empty()) {
+    return std::nullopt;
+  }
+  size_t pos = probe(name, std::hash<std::string_view>()(name));
+  if (table_[pos] == emptySlot) {
+    return std::nullopt;
+  }
+  return table_[pos];
+}
+
+size_t SymbolSlots::probe(std::string_view name, size_t hash) const {
+  size_t mask = table_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    slot_t slot = table_[pos];
+    if (slot == emptySlot || (hashes_[slot] == hash && names_[slot] == name)) {
+      return pos;
+    }
+  }
+}
+
+void SymbolSlots::grow() {
+  table_.assign(std::max<size_t>(64, 2 * table_.size()), emptySlot);
+  size_t mask = table_.size() - 1;
+  for (slot_t slot = 0; slot < names_.size(); ++slot) {
+    size_t pos = hashes_[slot] & mask;
+    while (table_[pos] != emptySlot) {
+      pos = (pos + 1) & mask;
+    }
+    table_[pos] = slot;
+  }
+}
+
 int AddExpr::evaluate(Environment &environment) const {
   return left_->evaluate(environment) + right_->evaluate(environment);
 }
@@ -53,3 +107,298 @@ int IntegerExpr::evaluate(Environment &environment) const { return value_; }
 int SymbolExpr::evaluate(Environment &environment) const {
   return environment.getSymbolValue(name_);
 }
+
+void AddExpr::compile(CompiledExpr &compiled) const {
+  left_->compile(compiled);
+  right_->compile(compiled);
+  compiled.emitBinary(CompiledExpr::Op::Add);
+}
+
+void SubtractExpr::compile(CompiledExpr &compiled) const {
+  left_->compile(compiled);
+  right_->compile(compiled);
+  compiled.emitBinary(CompiledExpr::Op::Subtract);
+}
+
+void MultExpr::compile(CompiledExpr &compiled) const {
+  left_->compile(compiled);
+  right_->compile(compiled);
+  compiled.emitBinary(CompiledExpr::Op::Multiply);
+}
+
+void DivideExpr::compile(CompiledExpr &compiled) const {
+  left_->compile(compiled);
+  right_->compile(compiled);
+  compiled.emitBinary(CompiledExpr::Op::Divide);
+}
+
+void NegativeExpr::compile(CompiledExpr &compiled) const {
+  value_->compile(compiled);
+  compiled.emitNegate();
+}
+
+void HereExpr::compile(CompiledExpr &compiled) const { compiled.emitHere(); }
+
+void ZeroExpr::compile(CompiledExpr &compiled) const { compiled.emitConst(0); }
+
+void IntegerExpr::compile(CompiledExpr &compiled) const {
+  compiled.emitConst(value_);
+}
+
+void SymbolExpr::compile(CompiledExpr &compiled) const {
+  compiled.emitSymbol(name_);
+}
+
+CompiledExpr::CompiledExpr(const Expr &expr, SymbolSlots &slots)
+    : slots_(&slots) {
+  expr.compile(*this);
+}
+
+void CompiledExpr::compile(CompiledExpr &compiled) const {
+  // Slots must be the same
+  assert(slots_ == compiled.slots_);
+  for (auto &code : code_) {
+    compiled.code_.push_back(code);
+  }
+  compiled.maxDepth_ =
+      std::max(compiled.maxDepth_, compiled.depth_ + maxDepth_);
+  compiled.depth_ += 1;
+}
+
+void CompiledExpr::adjustDepth(int change) {
+  depth_ += change;
+  maxDepth_ = std::max(maxDepth_, depth_);
+}
+
+void CompiledExpr::emitConst(int value) {
+  code_.push_back({Op::Const, value});
+  adjustDepth(1);
+}
+
+void CompiledExpr::emitHere() {
+  code_.push_back({Op::Here});
+  adjustDepth(1);
+}
+
+void CompiledExpr::emitSymbol(std::string_view name) {
+  code_.push_back({Op::Symbol, int32_t(slots_->getSlot(name))});
+  adjustDepth(1);
+}
+
+void CompiledExpr::emitBinary(Op op) {
+  size_t size = code_.size();
+  assert(size >= 2);
+  auto &left = code_[size - 2];
+  auto &right = code_[size - 1];
+  if (right.op == Op::Const) {
+    int value = right.arg;
+    if (left.op == Op::Const && !(op == Op::Divide && value == 0)) {
+      // Fold; division by zero is left for evaluation
+      switch (op) {
+      case Op::Add:
+        left.arg += value;
+        break;
+      case Op::Subtract:
+        left.arg -= value;
+        break;
+      case Op::Multiply:
+        left.arg *= value;
+        break;
+      case Op::Divide:
+        left.arg /= value;
+        break;
+      default:
+        assert(false);
+      }
+      code_.pop_back();
+      adjustDepth(-1);
+      return;
+    }
+    if (op == Op::Add || op == Op::Subtract) {
+      right = {Op::AddConst, op == Op::Add ? value : -value};
+      if (left.op == Op::AddConst) {
+        // x + a + b, from x + (a + b) after folding
+        left.arg += right.arg;
+        code_.pop_back();
+      }
+      adjustDepth(-1);
+      return;
+    }
+  }
+  code_.push_back({op});
+  adjustDepth(-1);
+}
+
+void CompiledExpr::emitNegate() {
+  auto &last = code_.back();
+  if (last.op == Op::Const) {
+    last.arg = -last.arg;
+  } else {
+    code_.push_back({Op::Negate});
+  }
+}
+
+int CompiledExpr::evaluate(Environment &environment) const {
+  constexpr size_t smallStack = 32;
+  std::array<int, smallStack> small;
+  std::vector<int> large;
+  int *stack = small.data();
+  if (maxDepth_ > smallStack) {
+    large.resize(maxDepth_);
+    stack = large.data();
+  }
+  size_t size = 0;
+  for (auto &code : code_) {
+    switch (code.op) {
+    case Op::Const:
+      stack[size++] = code.arg;
+      break;
+    case Op::Here:
+      stack[size++] = environment.getLocation();
+      break;
+    case Op::Symbol:
+      stack[size++] = environment.getSlotValue(*slots_, code.arg);
+      break;
+    case Op::AddConst:
+      stack[size - 1] += code.arg;
+      break;
+    case Op::Add:
+      --size;
+      stack[size - 1] += stack[size];
+      break;
+    case Op::Subtract:
+      --size;
+      stack[size - 1] -= stack[size];
+      break;
+    case Op::Multiply:
+      --size;
+      stack[size - 1] *= stack[size];
+      break;
+    case Op::Divide:
+      --size;
+      stack[size - 1] /= stack[size];
+      break;
+    case Op::Negate:
+      stack[size - 1] = -stack[size - 1];
+      break;
+    }
+  }
+  return stack[0];
+}
+
+ExprArena::~ExprArena() {
+  for (Link *link = last_; link; link = link->prev) {
+    link->node->~Expr();
+  }
+}
+
+namespace {
+constexpr size_t maxNodeSize = std::max(
+    {ExprArena::nodeSize<AddExpr>(), ExprArena::nodeSize<SubtractExpr>(),
+     ExprArena::nodeSize<MultExpr>(), ExprArena::nodeSize<DivideExpr>(),
+     ExprArena::nodeSize<NegativeExpr>(), ExprArena::nodeSize<HereExpr>(),
+     ExprArena::nodeSize<ZeroExpr>(), ExprArena::nodeSize<IntegerExpr>(),
+     ExprArena::nodeSize<SymbolExpr>()});
+
+constexpr size_t arenaSize = 1 << 16;
+
+constexpr std::array<bool, 256> symbolChars = []() {
+  std::array<bool, 256> table{};
+  for (char c = '0'; c <= '9'; ++c) {
+    table[uint8_t(c)] = true;
+  }
+  for (char c = 'A'; c <= 'Z'; ++c) {
+    table[uint8_t(c)] = true;
+  }
+  for (char c : {'#', '@', '_', '&', '.', '%'}) {
+    table[uint8_t(c)] = true;
+  }
+  return table;
+}();
+} // namespace
+
+bool EXPParser::parse(std::string_view text, std::vector<Expr::ptr> &exprs) {
+  // Every char adds at most two nodes, an operator or a negation and the value
+  // after it, so a parse can't run out of room
+  size_t needed = (2 * text.size() + 2) * maxNodeSize;
+  if (!arena_ || arena_->available() < needed) {
+    arena_ = std::make_shared<ExprArena>(std::max(arenaSize, needed));
+  }
+  next_ = text.data();
+  end_ = next_ + text.size();
+
+  std::vector<Expr::ptr> result;
+  result.push_back(parseExpr());
+  while (atChar(',')) {
+    ++next_;
+    result.push_back(parseExpr());
+  }
+  if (next_ < end_ && *next_ != ' ') {
+    return false;
+  }
+  for (auto &expr : result) {
+    expr = Expr::ptr(arena_, expr.get());
+  }
+  exprs = std::move(result);
+  return true;
+}
+
+Expr::ptr EXPParser::parseExpr() {
+  auto left = parseMult();
+  if (atChar('+')) {
+    ++next_;
+    return make<AddExpr>(left, parseExpr());
+  }
+  if (atChar('-')) {
+    ++next_;
+    return make<SubtractExpr>(left, parseExpr());
+  }
+  return left;
+}
+
+Expr::ptr EXPParser::parseMult() {
+  auto left = parseSValue();
+  if (atChar('*')) {
+    ++next_;
+    return make<MultExpr>(left, parseMult());
+  }
+  if (atChar('/')) {
+    ++next_;
+    return make<DivideExpr>(left, parseMult());
+  }
+  return left;
+}
+
+Expr::ptr EXPParser::parseSValue() {
+  if (atChar('-')) {
+    ++next_;
+    return make<NegativeExpr>(parseValue());
+  }
+  if (atChar('+')) {
+    ++next_;
+  }
+  return parseValue();
+}
+
+Expr::ptr EXPParser::parseValue() {
+  if (atChar('*')) {
+    ++next_;
+    if (atChar('*')) {
+      ++next_;
+      return make<ZeroExpr>();
+    }
+    return make<HereExpr>();
+  }
+  const char *start = next_;
+  uint64_t value = 0;
+  bool digits = true;
+  for (; next_ < end_ && symbolChars[uint8_t(*next_)]; ++next_) {
+    digits = digits && '0' <= *next_ && *next_ <= '9';
+    value = 10 * value + (*next_ - '0');
+  }
+  if (next_ > start && !digits) {
+    return make<SymbolExpr>(std::string_view(start, next_ - start));
+  }
+  // Digits, or empty for 0
+  return make<IntegerExpr>(int(value));
+}
@@ -157,19 +157,18 @@ std::vector<OpSpec> opSpecs704 = {
 };
 }
 std::optional<const OpSpec *> OpSpec::getOpSpec(const std::string_view &name) {
-  auto initOps = []() -> std::map<const std::string_view, const OpSpec *> {
-    std::map<const std::string_view, const OpSpec *> ops;
+  auto initOps = []() -> MnemonicTable<const OpSpec *> {
+    std::vector<MnemonicTable<const OpSpec *>::Entry> ops;
     for (const auto &opSpec : opSpecs704) {
-      ops[opSpec.getOperation()] = &opSpec;
+      ops.emplace_back(opSpec.getOperation(), &opSpec);
     }
     return ops;
   };
 
-  static std::map<const std::string_view, const OpSpec *> ops = initOps();
+  static const MnemonicTable<const OpSpec *> ops = initOps();
 
-  auto it = ops.find(name);
-  if (it != ops.end()) {
-    return it->second;
+  if (auto opSpec = ops.find(name)) {
+    return *opSpec;
   }
   return std::optional<const OpSpec *>();
 }
@@ -23,9 +23,9 @@
 #include "Z0ftware/operation.hpp"
 #include "Z0ftware/asm.hpp"
 #include "Z0ftware/charset.hpp"
+#include "Z0ftware/decimal.hpp"
 #include "Z0ftware/disasm.hpp"
 #include "Z0ftware/op.hpp"
-#include "Z0ftware/parser.hpp"
 #include "Z0ftware/utils.hpp"
 
 std::pair<std::string_view, std::string_view>
@@ -66,17 +66,7 @@ Section &Operation::getSection(Assembler &assembler) const {
 void Bcd::parseVariable(Assembler &assembler,
                         const std::string_view &variable) {
   size_t count = 10;
-  std::string_view::size_type pos = 0;
-  std::string_view::size_type limit = variable.size();
-  auto take = [this, &pos, &limit, &variable]() {
-    if (pos < limit) {
-      return variable[pos++];
-    }
-    pos++;
-    return ' ';
-  };
-
-  auto countChar = take();
+  char countChar = variable.empty() ? ' ' : variable[0];
   if (countChar != ' ') {
     if ('0' < countChar && countChar <= '9') {
       count = countChar - '0';
@@ -84,13 +74,13 @@ void Bcd::parseVariable(Assembler &assembler,
       addWarning() << "Invalid BCD count, using 10";
     }
   }
-  char buffer[6];
-  for (int i = 0; i < count; ++i) {
-    for (int j = 0; j < 6; j++) {
-      buffer[j] = take();
-    }
-    values_.push_back(bcd(std::string_view(&buffer[0], &buffer[6])));
-  }
+  // Characters past the end of the variable are blank
+  auto &charSet = assembler.getCharSet();
+  std::vector<bcd_t> chars(count * bcdPerWord, charSet.getCPUBCD(U' '));
+  charSet.encode(variable.substr(std::min<size_t>(1, variable.size())), chars);
+  std::vector<word_t> words(count);
+  packBCD(chars, words);
+  values_.assign(words.begin(), words.end());
 }
 
 void Bcd::allocate(Assembler &assembler, Chunk &chunk) const {
@@ -136,9 +126,7 @@ void Bss::assemble(Assembler &assembler, Chunk &chunk) const {
 
 void Dec::parseVariable(Assembler &assembler,
                         const std::string_view &variable) {
-  static PegDECParser parser;
-  bool success = parser.parse(variable, values_);
-  if (!success) {
+  if (!parseDEC(variable, values_)) {
     addError() << "Could not parse DEC";
   }
 }
@@ -88,6 +88,10 @@ std::streamsize P7BIStream::read(char *buffer, std::streamsize size) {
   }
   if (bufferNext_ == bufferEnd_) {
     fillTapeBuffer();
+    if (eot_) {
+      // recordEnd_ still points into the previous buffer
+      return 0;
+    }
   }
   std::streamsize toCopy =
       std::min<std::streamsize>(recordEnd_ - bufferNext_, size);
@@ -25,6 +25,7 @@
 #include "Z0ftware/word.hpp"
 
 #include <any>
+#include <sstream>
 #include <string>
 
 namespace {
@@ -31,15 +31,22 @@ void ShareReader::fillRecordBuffer() {
     return;
   }
 
+  // Unread chars of a card that continues past the buffer are kept
+  size_t carry = recordBufferEnd_ - recordBufferNext_;
   if (input_.isEOR()) {
     if (!input_.nextRecord()) {
       return;
     }
+    carry = 0;
+    recordBufferOffset_ = 0;
+  } else {
+    recordBufferOffset_ += recordBufferNext_ - recordBufferStart_;
   }
 
-  recordBufferEnd_ = recordBufferStart_;
+  std::copy(recordBufferNext_, recordBufferNext_ + carry, recordBufferStart_);
+  recordBufferEnd_ = recordBufferStart_ + carry;
   recordBufferNext_ = recordBufferStart_;
-  char *bufferEnd = recordBufferEnd_ + recordBuffer_.size();
+  char *bufferEnd = recordBufferStart_ + recordBuffer_.size();
   while (recordBufferEnd_ < bufferEnd) {
     auto numRead = input_.read(recordBufferEnd_, bufferEnd - recordBufferEnd_);
     if (numRead == 0) {
@@ -47,13 +54,14 @@ void ShareReader::fillRecordBuffer() {
     }
     recordBufferEnd_ += numRead;
   }
-  size_t evenParityCount =
-      std::count_if(recordBufferStart_, recordBufferEnd_,
-                    [](char c) { return isEvenParity(even_parity_bcd_t(c)); });
+  size_t evenParityCount = std::count_if(
+      recordBufferStart_, recordBufferEnd_, [](char c) {
+        return 0 != (frameDecodeTable[uint8_t(c)] & frameEvenOk);
+      });
 
   size_t size = recordBufferEnd_ - recordBufferStart_;
   isBCD_ = evenParityCount * 2 > size;
-  if (isBCD_ && size <= 84) {
+  if (isBCD_ && size <= 84 && 0 == carry) {
     recordBufferHasHeader_ = true;
   }
 }
@@ -90,6 +98,28 @@ std::streamsize ShareReader::read(char *buffer, std::streamsize count) {
   return toCopy;
 }
 
+std::span<const char> ShareReader::nextCard() {
+  initialize();
+  size_t cardSize = headerBufferEnd_ - headerBufferStart_;
+  size_t available = recordBufferEnd_ - recordBufferNext_;
+  if (0 == available || (available < cardSize && !input_.isEOR())) {
+    fillRecordBuffer();
+  }
+
+  if (recordBufferHasHeader_ || recordBufferNext_ == recordBufferEnd_ ||
+      0 == cardSize) {
+    // End of deck
+    return {};
+  }
+
+  size_t size =
+      std::min<size_t>(cardSize, recordBufferEnd_ - recordBufferNext_);
+  std::span<const char> card(recordBufferNext_, size);
+  cardOffset_ = recordBufferOffset_ + (recordBufferNext_ - recordBufferStart_);
+  recordBufferNext_ += size;
+  return card;
+}
+
 bool ShareReader::nextDeck() {
   if (!recordBufferHasHeader_) {
     // TODO: Read records until deck header is found
@@ -0,0 +1,269 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/tapediff.hpp"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+TapeRecords::TapeRecords(TapeIRecordStream &input) {
+  std::array<char, 4096> buffer;
+  size_t begin = 0;
+  while (true) {
+    auto numRead = input.read(buffer.data(), buffer.size());
+    if (numRead > 0) {
+      data_.append(buffer.data(), numRead);
+      continue;
+    }
+    size_t size = data_.size() - begin;
+    if (size > 0 || !input.isEOT()) {
+      records_.push_back({.recordNum = input.getRecordNum(),
+                          .pos = input.getRecordPos(),
+                          .begin = begin,
+                          .size = size,
+                          .hash = hash(std::string_view(data_).substr(begin))});
+    }
+    begin = data_.size();
+    if (!input.nextRecord()) {
+      break;
+    }
+  }
+}
+
+uint64_t TapeRecords::hash(std::string_view data) {
+  // FNV-1a
+  uint64_t result = 0xcbf29ce484222325;
+  for (auto c : data) {
+    result = (result ^ uint8_t(c)) * 0x100000001b3;
+  }
+  return result;
+}
+
+namespace {
+class PatienceDiff {
+public:
+  PatienceDiff(const std::vector<uint64_t> &left,
+               const std::vector<uint64_t> &right)
+      : left_(left), right_(right) {}
+
+  std::vector<TapeDiffHunk> diff() {
+    diffRange(0, left_.size(), 0, right_.size());
+    return std::move(hunks_);
+  }
+
+private:
+  // Largest gap that will be aligned with a quadratic LCS when there are no
+  // unique records to anchor on
+  static constexpr size_t lcsLimit_ = 1 << 20;
+
+  void addHunk(size_t leftBegin, size_t leftEnd, size_t rightBegin,
+               size_t rightEnd) {
+    if (leftBegin == leftEnd && rightBegin == rightEnd) {
+      return;
+    }
+    if (!hunks_.empty()) {
+      auto &last = hunks_.back();
+      if (last.leftEnd == leftBegin && last.rightEnd == rightBegin) {
+        last.leftEnd = leftEnd;
+        last.rightEnd = rightEnd;
+        return;
+      }
+    }
+    hunks_.push_back({leftBegin, leftEnd, rightBegin, rightEnd});
+  }
+
+  void diffRange(size_t leftBegin, size_t leftEnd, size_t rightBegin,
+                 size_t rightEnd) {
+    while (leftBegin < leftEnd && rightBegin < rightEnd &&
+           left_[leftBegin] == right_[rightBegin]) {
+      ++leftBegin;
+      ++rightBegin;
+    }
+    while (leftBegin < leftEnd && rightBegin < rightEnd &&
+           left_[leftEnd - 1] == right_[rightEnd - 1]) {
+      --leftEnd;
+      --rightEnd;
+    }
+    if (leftBegin == leftEnd || rightBegin == rightEnd) {
+      addHunk(leftBegin, leftEnd, rightBegin, rightEnd);
+      return;
+    }
+
+    auto anchors = uniqueAnchors(leftBegin, leftEnd, rightBegin, rightEnd);
+    if (anchors.empty()) {
+      lcsRange(leftBegin, leftEnd, rightBegin, rightEnd);
+      return;
+    }
+    for (auto [left, right] : anchors) {
+      diffRange(leftBegin, left, rightBegin, right);
+      leftBegin = left + 1;
+      rightBegin = right + 1;
+    }
+    diffRange(leftBegin, leftEnd, rightBegin, rightEnd);
+  }
+
+  // Hashes that occur exactly once on each side, reduced to the longest
+  // sequence increasing on both sides.
+  std::vector<std::pair<size_t, size_t>> uniqueAnchors(size_t leftBegin,
+                                                       size_t leftEnd,
+                                                       size_t rightBegin,
+                                                       size_t rightEnd) {
+    struct Count {
+      size_t left{0};
+      size_t right{0};
+      size_t leftPos{0};
+      size_t rightPos{0};
+    };
+    std::unordered_map<uint64_t, Count> counts;
+    counts.reserve(leftEnd - leftBegin + rightEnd - rightBegin);
+    for (auto i = leftBegin; i < leftEnd; ++i) {
+      auto &count = counts[left_[i]];
+      count.left++;
+      count.leftPos = i;
+    }
+    for (auto i = rightBegin; i < rightEnd; ++i) {
+      auto &count = counts[right_[i]];
+      count.right++;
+      count.rightPos = i;
+    }
+    std::vector<std::pair<size_t, size_t>> candidates;
+    for (auto i = leftBegin; i < leftEnd; ++i) {
+      auto &count = counts[left_[i]];
+      if (count.left == 1 && count.right == 1) {
+        candidates.emplace_back(i, count.rightPos);
+      }
+    }
+
+    // Patience sort on the right positions
+    std::vector<size_t> tails;
+    std::vector<size_t> previous(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      auto it = std::lower_bound(tails.begin(), tails.end(), i,
+                                 [&candidates](size_t tail, size_t i) {
+                                   return candidates[tail].second <
+                                          candidates[i].second;
+                                 });
+      previous[i] = it == tails.begin() ? candidates.size() : *(it - 1);
+      if (it == tails.end()) {
+        tails.push_back(i);
+      } else {
+        *it = i;
+      }
+    }
+    std::vector<std::pair<size_t, size_t>> anchors(tails.size());
+    auto pos = tails.empty() ? candidates.size() : tails.back();
+    for (auto it = anchors.rbegin(); it != anchors.rend(); ++it) {
+      *it = candidates[pos];
+      pos = previous[pos];
+    }
+    return anchors;
+  }
+
+  // Classic LCS for small regions with no unique records
+  void lcsRange(size_t leftBegin, size_t leftEnd, size_t rightBegin,
+                size_t rightEnd) {
+    size_t rows = leftEnd - leftBegin;
+    size_t cols = rightEnd - rightBegin;
+    if (rows * cols > lcsLimit_) {
+      addHunk(leftBegin, leftEnd, rightBegin, rightEnd);
+      return;
+    }
+    std::vector<uint32_t> lengths((rows + 1) * (cols + 1), 0);
+    auto at = [cols, &lengths](size_t row, size_t col) -> uint32_t & {
+      return lengths[row * (cols + 1) + col];
+    };
+    for (size_t row = rows; row-- > 0;) {
+      for (size_t col = cols; col-- > 0;) {
+        at(row, col) =
+            left_[leftBegin + row] == right_[rightBegin + col]
+                ? at(row + 1, col + 1) + 1
+                : std::max(at(row + 1, col), at(row, col + 1));
+      }
+    }
+    size_t row = 0;
+    size_t col = 0;
+    size_t hunkRow = 0;
+    size_t hunkCol = 0;
+    while (row < rows && col < cols) {
+      if (left_[leftBegin + row] == right_[rightBegin + col]) {
+        addHunk(leftBegin + hunkRow, leftBegin + row, rightBegin + hunkCol,
+                rightBegin + col);
+        hunkRow = ++row;
+        hunkCol = ++col;
+      } else if (at(row + 1, col) >= at(row, col + 1)) {
+        ++row;
+      } else {
+        ++col;
+      }
+    }
+    addHunk(leftBegin + hunkRow, leftEnd, rightBegin + hunkCol, rightEnd);
+  }
+
+  const std::vector<uint64_t> &left_;
+  const std::vector<uint64_t> &right_;
+  std::vector<TapeDiffHunk> hunks_;
+};
+
+// Numbers the distinct records of both tapes, so records get the same id only
+// if their bytes are the same, even when their hashes collide
+class RecordIds {
+public:
+  std::vector<uint64_t> ids(const TapeRecords &records) {
+    std::vector<uint64_t> result;
+    result.reserve(records.getRecords().size());
+    for (auto &record : records.getRecords()) {
+      result.push_back(id(records.getData(record), record.hash));
+    }
+    return result;
+  }
+
+private:
+  uint64_t id(std::string_view data, uint64_t hash) {
+    auto &candidates = byHash_[hash];
+    for (auto &[candidate, id] : candidates) {
+      if (candidate == data) {
+        return id;
+      }
+    }
+    candidates.push_back({data, nextId_});
+    return nextId_++;
+  }
+
+  std::unordered_map<uint64_t,
+                     std::vector<std::pair<std::string_view, uint64_t>>>
+      byHash_;
+  uint64_t nextId_{0};
+};
+} // namespace
+
+std::vector<TapeDiffHunk> diffHashes(const std::vector<uint64_t> &left,
+                                     const std::vector<uint64_t> &right) {
+  return PatienceDiff(left, right).diff();
+}
+
+std::vector<TapeDiffHunk> diffRecords(const TapeRecords &left,
+                                      const TapeRecords &right) {
+  RecordIds recordIds;
+  auto leftIds = recordIds.ids(left);
+  return diffHashes(leftIds, recordIds.ids(right));
+}
@@ -22,22 +22,42 @@
 
 #include "Z0ftware/tapeeditstream.hpp"
 
+#include <limits>
+#include <optional>
+
 void ReaderEditor::addEdit(pos_type begin, pos_type end,
                            std::string replacement) {
-  edits_.insert({.begin = begin, .end = end, .replacement = replacement});
+  auto &saved = replacements_.emplace_back(std::move(replacement));
+  edits_.insert({.begin = begin, .end = end, .replacement = saved});
+}
+
+bool ReaderEditor::takeEdit(Edit &edit) {
+  std::optional<Edit> listEdit;
+  if (editList_ && editListPos_ < editList_->getOffsetEdits().size()) {
+    auto &entry = editList_->getOffsetEdits()[editListPos_];
+    listEdit = Edit{.begin = entry.begin,
+                    .end = entry.end,
+                    .replacement = editList_->getReplacement(entry)};
+  }
+  if (editIt_ != edits_.end() && (!listEdit || *editIt_ <= *listEdit)) {
+    edit = *editIt_++;
+    return true;
+  }
+  if (listEdit) {
+    edit = *listEdit;
+    editListPos_++;
+    return true;
+  }
+  return false;
 }
 
 std::streamsize ReaderEditor::read(char *buffer, std::streamsize count) {
   if (!initialized_) {
     tellg_ = input_.tellg();
     editIt_ = edits_.begin();
+    editListPos_ = 0;
     nextEdit_ = Edit{.begin = 0, .end = 0, .replacement = ""};
     initialized_ = true;
-    if (editIt_ == edits_.end()) {
-      nextEdit_.begin = std::numeric_limits<off_type>::max();
-      nextEdit_.end = std::numeric_limits<off_type>::max();
-      nextEdit_.replacement = "";
-    }
   }
 
   if (input_.eof() || input_.fail()) {
@@ -46,13 +66,11 @@ std::streamsize ReaderEditor::read(char *buffer, std::streamsize count) {
 
   while (true) {
     while (nextEdit_.begin == nextEdit_.end && nextEdit_.replacement.empty()) {
-      if (editIt_ == edits_.end()) {
+      if (!takeEdit(nextEdit_)) {
         nextEdit_.begin = std::numeric_limits<off_type>::max();
         nextEdit_.end = std::numeric_limits<off_type>::max();
         nextEdit_.replacement = "";
         break;
-      } else {
-        nextEdit_ = *editIt_++;
       }
     }
 
@@ -85,10 +103,32 @@ std::streamsize ReaderEditor::read(char *buffer, std::streamsize count) {
 
 void TapeIRecordStreamEditor::addEdit(size_t recordNum, pos_type begin,
                                       pos_type end, std::string replacement) {
+  auto &saved = replacements_.emplace_back(std::move(replacement));
   edits_.insert({.recordNum = recordNum,
                  .begin = begin,
                  .end = end,
-                 .replacement = replacement});
+                 .replacement = saved});
+}
+
+bool TapeIRecordStreamEditor::takeEdit(Edit &edit) {
+  std::optional<Edit> listEdit;
+  if (editList_ && editListPos_ < editList_->getRecordOffsetEdits().size()) {
+    auto &entry = editList_->getRecordOffsetEdits()[editListPos_];
+    listEdit = Edit{.recordNum = entry.recordNum,
+                    .begin = entry.begin,
+                    .end = entry.end,
+                    .replacement = editList_->getReplacement(entry)};
+  }
+  if (editIt_ != edits_.end() && (!listEdit || *editIt_ <= *listEdit)) {
+    edit = *editIt_++;
+    return true;
+  }
+  if (listEdit) {
+    edit = *listEdit;
+    editListPos_++;
+    return true;
+  }
+  return false;
 }
 
 std::streamsize TapeIRecordStreamEditor::read(char *buffer,
@@ -96,14 +136,9 @@ std::streamsize TapeIRecordStreamEditor::read(char *buffer,
   if (!initialized_) {
     tellg_ = input_.tellg();
     editIt_ = edits_.begin();
+    editListPos_ = 0;
     nextEdit_ = Edit{.recordNum = 0, .begin = 0, .end = 0, .replacement = ""};
     initialized_ = true;
-    if (editIt_ == edits_.end()) {
-      nextEdit_.recordNum = std::numeric_limits<size_t>::max();
-      nextEdit_.begin = std::numeric_limits<off_type>::max();
-      nextEdit_.end = std::numeric_limits<off_type>::max();
-      nextEdit_.replacement = "";
-    }
   }
 
   if (input_.eof() || input_.fail()) {
@@ -112,14 +147,12 @@ std::streamsize TapeIRecordStreamEditor::read(char *buffer,
 
   while (true) {
     while (nextEdit_.begin == nextEdit_.end && nextEdit_.replacement.empty()) {
-      if (editIt_ == edits_.end()) {
+      if (!takeEdit(nextEdit_)) {
         nextEdit_.recordNum = std::numeric_limits<size_t>::max();
         nextEdit_.begin = std::numeric_limits<off_type>::max();
         nextEdit_.end = std::numeric_limits<off_type>::max();
         nextEdit_.replacement = "";
         break;
-      } else {
-        nextEdit_ = *editIt_++;
       }
     }
 
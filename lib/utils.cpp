@@ -24,6 +24,7 @@
 
 #include <iomanip>
 #include <utility>
+#include <vector>
 
 std::string_view trim(std::string_view text) {
   auto pos = text.find_first_not_of(" ");
@@ -45,3 +46,33 @@ std::string_view rightTrim(std::string_view text) {
   }
   return text;
 }
+
+MultiplicativeHash findPerfectHash(std::span<const uint32_t> keys,
+                                   unsigned keyBits) {
+  MultiplicativeHash hash;
+  while (hash.size() < 2 * keys.size()) {
+    ++hash.bits;
+  }
+  hash.multiplier = 0x9E3779B1;
+  std::vector<bool> used;
+  for (; hash.bits < keyBits; ++hash.bits) {
+    for (unsigned tries = 0; tries < 256; ++tries) {
+      used.assign(hash.size(), false);
+      bool collision = false;
+      for (auto key : keys) {
+        auto slot = hash(key);
+        if (used[slot]) {
+          collision = true;
+          break;
+        }
+        used[slot] = true;
+      }
+      if (!collision) {
+        return hash;
+      }
+      hash.multiplier = (hash.multiplier * 1664525 + 1013904223) | 1;
+    }
+  }
+  // Shifting the keys to the top bits and back is always perfect
+  return {keyBits, uint32_t(1) << (32 - keyBits)};
+}
@@ -22,6 +22,7 @@
 
 #include "Z0ftware/asm.hpp"
 #include "Z0ftware/card.hpp"
+#include "Z0ftware/charset.hpp"
 #include "Z0ftware/config.h"
 #include "Z0ftware/disasm.hpp"
 #include "Z0ftware/operation.hpp"
@@ -43,6 +44,19 @@ llvm::cl::opt<std::string>
 llvm::cl::list<std::string> inputFileNames(llvm::cl::Positional,
                                            llvm::cl::desc("<Input files>"),
                                            llvm::cl::OneOrMore);
+
+llvm::cl::opt<std::string>
+    charsetName("charset", llvm::cl::desc("Charset for BCD pseudo-op text"),
+                llvm::cl::value_desc("name"));
+
+llvm::cl::opt<bool>
+    cardInput("cards",
+              llvm::cl::desc("Input files are CBN decks of source cards"));
+
+llvm::cl::opt<bool>
+    pegEXP("peg-exp",
+           llvm::cl::desc("Parse expressions with the reference PEG parser"),
+           llvm::cl::Hidden);
 } // namespace
 
 int main(int argc, const char **argv) {
@@ -57,17 +71,35 @@ int main(int argc, const char **argv) {
       "  does so considerably faster.\n");
 
   SAPAssembler sapAssembler;
+  sapAssembler.setPegEXP(pegEXP);
+  // Source cards are read with the assembler's charset
+  const NamedCharset *charset = findNamedCharset("sherman");
+  if (!charsetName.empty()) {
+    charset = findNamedCharset(charsetName);
+    if (!charset) {
+      std::cerr << "Unknown charset " << charsetName << ", choose from:\n";
+      for (auto &namedCharset : getNamedCharsets()) {
+        std::cerr << "  " << namedCharset.getName() << ": "
+                  << namedCharset.getDescription() << "\n";
+      }
+      return EXIT_FAILURE;
+    }
+    sapAssembler.setCharSet(charset->getCPUCharSet());
+  }
   std::ofstream os(outputFileName, std::ofstream::binary | std::ofstream::out |
                                        std::ofstream::trunc);
+  CardDeckWriter deckWriter(os);
   if (!outputFileName.empty()) {
-    section_writer_t sectionWriter = [&os](const Section &section) {
+    section_writer_t sectionWriter = [&deckWriter](const Section &section) {
       CardImage cardImage;
+      // Words are collected and transposed to columns when the card is done
+      CardImage::words_t cardWords{0};
       int pos = 0;
       addr_t cardBeginAddr = 0;
       addr_t cardEndAddr = cardBeginAddr;
       uint64_t checksum = 0;
       auto finishCard = [&section, &cardBeginAddr, &cardEndAddr, &cardImage,
-                         &os, &pos, &checksum]() {
+                         &cardWords, &deckWriter, &pos, &checksum]() {
         switch (section.getBinaryFormat()) {
         case BinaryFormat::Absolute: {
           word_t L = 0;
@@ -76,22 +108,23 @@ int main(int argc, const char **argv) {
           dpb<15, 3>(0, L);
           dpb<0, 15>(cardBeginAddr, L);
           checksum += L;
-          cardImage.setWord(0, L);
-          cardImage.setWord(1, checksum % ((uint64_t(1) << 36) - 1));
+          cardWords[0] = L;
+          cardWords[1] = checksum % ((uint64_t(1) << 36) - 1);
           break;
         }
         case BinaryFormat::Relative: {
           std::cerr << "Relative not supported\n";
-          cardImage.setWord(0, 0);
-          cardImage.setWord(1, 0);
+          cardWords[0] = 0;
+          cardWords[1] = 0;
           break;
         }
         case BinaryFormat::Full: {
           break;
         }
         }
-        writeCBN(os, cardImage);
-        cardImage.clear();
+        cardImage.setWords(cardWords);
+        deckWriter.write(cardImage);
+        cardWords.fill(0);
         pos = 0;
       };
       for (auto &chunk : section.getChunks()) {
@@ -111,7 +144,7 @@ int main(int argc, const char **argv) {
             }
             }
           }
-          cardImage.setWord(pos++, *it);
+          cardWords[pos++] = *it;
           checksum += *it;
           cardEndAddr++;
           if (24 == pos) {
@@ -122,26 +155,27 @@ int main(int argc, const char **argv) {
           if (pos > 0) {
             finishCard();
           }
-          cardImage.clear();
+          cardWords.fill(0);
           switch (section.getBinaryFormat()) {
           case BinaryFormat::Absolute: {
             word_t L = 0;
             dpb<0, 15>(chunk.getTransfer(), L);
-            cardImage.setWord(0, L);
-            cardImage.setWord(1, 0);
+            cardWords[0] = L;
+            cardWords[1] = 0;
             break;
           }
           case BinaryFormat::Full:
             break;
           case BinaryFormat::Relative: {
             std::cerr << "Relative not supported\n";
-            cardImage.setWord(0, 0);
-            cardImage.setWord(1, 0);
+            cardWords[0] = 0;
+            cardWords[1] = 0;
             break;
           }
           }
-          writeCBN(os, cardImage);
-          cardImage.clear();
+          cardImage.setWords(cardWords);
+          deckWriter.write(cardImage);
+          cardWords.fill(0);
           pos = 0;
         }
       }
@@ -166,14 +200,27 @@ int main(int argc, const char **argv) {
   }
   std::vector<SAPDeck> decks;
   for (auto &inputFileName : inputFileNames) {
-    std::ifstream is(inputFileName);
-    auto &sapDeck = decks.emplace_back(SAPDeck(is));
-    for (auto &card : sapDeck.getCards()) {
-      auto operation = sapAssembler.parseLine(card);
+    auto &sapDeck = decks.emplace_back();
+    if (cardInput) {
+      sapDeck = SAPDeck(CardDeck(inputFileName), *charset);
+      if (sapDeck.getNumSubstituted() > 0) {
+        std::cerr << inputFileName << ": " << sapDeck.getNumSubstituted()
+                  << " columns have no " << charset->getName()
+                  << " character\n";
+        return EXIT_FAILURE;
+      }
+    } else {
+      std::ifstream is(inputFileName);
+      sapDeck = SAPDeck(is);
+    }
+    auto fields = SAPAssembler::extractFields(sapDeck.getCards());
+    for (size_t pos = 0; pos < fields.size(); ++pos) {
+      auto operation = sapAssembler.parseCard(fields, pos);
       sapAssembler.appendOperation(std::move(operation));
     }
   }
   sapAssembler.assemble();
+  deckWriter.flush();
   os.close();
 
   return EXIT_SUCCESS;
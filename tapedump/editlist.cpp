@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Convert JSON tape edits to a binary edit list for sharedump --edits
+
+#include "Z0ftware/config.h"
+#include "Z0ftware/editlist.hpp"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+llvm::cl::opt<std::string> inputFileName(llvm::cl::Positional,
+                                         llvm::cl::desc("<JSON edits>"),
+                                         llvm::cl::Required);
+
+llvm::cl::opt<std::string> outputFileName("o",
+                                          llvm::cl::desc("Output edit list"),
+                                          llvm::cl::value_desc("filename"),
+                                          llvm::cl::Required);
+} // namespace
+
+int main(int argc, const char **argv) {
+  llvm::cl::SetVersionPrinter([](llvm::raw_ostream &os) {
+    os << "Version " << Z0ftware_VERSION_MAJOR << "." << Z0ftware_VERSION_MINOR
+       << "." << Z0ftware_VERSION_PATCH << "\n";
+  });
+
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Edit list converter\n\n"
+      "  This program converts the JSON edits used by sharedump to a binary\n"
+      "  edit list that sharedump can map instead of parsing.\n");
+
+  std::ifstream input(inputFileName);
+  if (!input.is_open()) {
+    std::cerr << "Could not open " << inputFileName << "\n";
+    return EXIT_FAILURE;
+  }
+  json editObj = json::parse(input);
+
+  EditList::Writer writer;
+  for (auto &editItem : editObj["offsets"]) {
+    int64_t start = editItem[0];
+    int64_t end = editItem[1];
+    std::string replacement = editItem[2];
+    writer.addEdit(start, end, replacement);
+  }
+  for (auto &editItem : editObj["record-offsets"]) {
+    uint64_t recordNum = editItem[0];
+    int64_t start = editItem[1];
+    int64_t end = editItem[2];
+    std::string replacement = editItem[3];
+    writer.addEdit(recordNum, start, end, replacement);
+  }
+
+  std::ofstream output(outputFileName,
+                       std::ofstream::binary | std::ofstream::out);
+  writer.write(output);
+  if (!output) {
+    std::cerr << "Could not write " << outputFileName << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 
 #include "Z0ftware/charset.hpp"
 #include "Z0ftware/config.h"
+#include "Z0ftware/editlist.hpp"
 #include "Z0ftware/p7bistream.hpp"
 #include "Z0ftware/sharereader.hpp"
 #include "Z0ftware/tape.hpp"
@@ -38,6 +39,8 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <span>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -105,6 +108,26 @@ llvm::cl::opt<bool> showTapePos("show-tape-pos",
 llvm::cl::opt<std::string> edits("edits",
                                  llvm::cl::desc("Edits for tape file"));
 
+llvm::cl::opt<std::string>
+    charsetName("charset", llvm::cl::desc("Charset for BCD text"),
+                llvm::cl::value_desc("name"), llvm::cl::init("collated"));
+
+llvm::cl::opt<bool> detectCharset(
+    "detect-charset",
+    llvm::cl::desc("Choose the charset for each deck from its characters"),
+    llvm::cl::init(false));
+
+// A text card, or the first card of a binary record, held until the deck's
+// charset is known
+struct DeckCard {
+  Reader::pos_type tapePos;
+  size_t recordNum;
+  size_t cardNumber;
+  bool binary;
+  size_t framesPos;
+  size_t framesSize;
+};
+
 } // namespace
 
 static auto hexDump(std::string title, size_t byteGroupSize, size_t lineSize) {
@@ -164,6 +187,16 @@ int main(int argc, const char **argv) {
 
   std::setlocale(LC_ALL, "");
 
+  const NamedCharset *charset = findNamedCharset(charsetName);
+  if (!charset) {
+    std::cerr << "Unknown charset " << charsetName << ", choose from:\n";
+    for (auto &namedCharset : getNamedCharsets()) {
+      std::cerr << "  " << namedCharset.getName() << ": "
+                << namedCharset.getDescription() << "\n";
+    }
+    return EXIT_FAILURE;
+  }
+
   for (auto &inputFileName : inputFileNames) {
     std::ifstream input(inputFileName,
                         std::ifstream::binary | std::ifstream::in);
@@ -182,10 +215,16 @@ int main(int argc, const char **argv) {
       inputReadObserver->addReadEventListener(hexDump("Input", 4, 64));
     }
 
+    // Edits are either JSON or a binary edit list made by editlist
     json editObj;
+    std::unique_ptr<EditList> editList;
     if (!edits.empty()) {
-      std::ifstream editsFile(edits);
-      editObj = json::parse(editsFile);
+      if (EditList::isEditList(edits)) {
+        editList = std::make_unique<EditList>(edits);
+      } else {
+        std::ifstream editsFile(edits);
+        editObj = json::parse(editsFile);
+      }
     }
 
     std::unique_ptr<ReaderEditor> offsetEditor;
@@ -200,7 +239,8 @@ int main(int argc, const char **argv) {
       }
 
       auto &readerEditList = editObj["offsets"];
-      if (!readerEditList.empty()) {
+      if (!readerEditList.empty() ||
+          (editList && !editList->getOffsetEdits().empty())) {
         offsetEditor = std::make_unique<ReaderEditor>(*reader);
         reader = offsetEditor.get();
         for (auto &editItem : readerEditList) {
@@ -209,6 +249,9 @@ int main(int argc, const char **argv) {
           std::string replacement = editItem[2];
           offsetEditor->addEdit(start, end, replacement);
         }
+        if (editList) {
+          offsetEditor->addEdits(*editList);
+        }
       }
 
       if (dumpOffsetEditOutputds) {
@@ -244,7 +287,8 @@ int main(int argc, const char **argv) {
     std::unique_ptr<TapeIRecordStreamObserver> recordOffsetEditorOutputObserver;
     if (!edits.empty()) {
       auto &tapeIRecordEditList = editObj["record-offsets"];
-      if (!tapeIRecordEditList.empty()) {
+      if (!tapeIRecordEditList.empty() ||
+          (editList && !editList->getRecordOffsetEdits().empty())) {
 
         if (dumpRecordOffsetEditInputs) {
           recordOffsetEditorInputObserver =
@@ -264,6 +308,9 @@ int main(int argc, const char **argv) {
           std::string replacement = editItem[3];
           recordOffsetEditor->addEdit(recordNum, start, end, replacement);
         }
+        if (editList) {
+          recordOffsetEditor->addEdits(*editList);
+        }
 
         if (dumpRecordOffsetEditOutputs) {
           recordOffsetEditorOutputObserver =
@@ -275,35 +322,73 @@ int main(int argc, const char **argv) {
       }
     }
 
-    std::unique_ptr<parity_glyphs_t> tapeChars =
-        collateGlyphCardTape.getTapeCharset(true);
-    size_t cardNumber = 0;
+    // The chosen charset is first so it wins ties
+    std::vector<const NamedCharset *> tapeCharsets{charset};
+    std::vector<const parity_glyphs_t *> candidates;
+    if (detectCharset) {
+      for (auto &namedCharset : getNamedCharsets()) {
+        if (&namedCharset != charset) {
+          tapeCharsets.push_back(&namedCharset);
+        }
+      }
+      for (auto tapeCharset : tapeCharsets) {
+        candidates.push_back(&tapeCharset->getTapeGlyphs());
+      }
+    }
+    std::string header;
+    std::string deckFrames;
+    std::vector<DeckCard> deckCards;
+    bcd_histogram_t histogram;
+    std::string headerText;
+    std::string cardText;
     ShareReader shareReader(*tapeReader);
 
-    auto showPosition = [&shareReader, &cardNumber](Reader::pos_type offset) {
+    auto showPosition = [](const DeckCard &card) {
       if (showTapePos) {
-        std::cout << std::setw(12) << std::setfill('0')
-                  << shareReader.getRecordPos() + offset << " ";
+        std::cout << std::setw(12) << std::setfill('0') << card.tapePos << " ";
       }
       if (showCardNumber) {
-        std::cout << std::setw(4) << std::setfill('0')
-                  << shareReader.getRecordNum() << ":" << std::setw(4)
-                  << std::setfill('0') << cardNumber << " ";
+        std::cout << std::setw(4) << std::setfill('0') << card.recordNum << ":"
+                  << std::setw(4) << std::setfill('0') << card.cardNumber
+                  << " ";
       }
     };
 
-    char buffer[4096];
     while (!shareReader.eof()) {
-      cardNumber = 0;
       // Deck header
-      std::string_view header = shareReader.getDeckHeader();
-      auto lineSize = header.size();
+      header = shareReader.getDeckHeader();
+
+      size_t charsetIndex = 0;
+      if (detectCharset) {
+        // Read the whole deck so its charset can be chosen before showing it
+        deckFrames.clear();
+        deckCards.clear();
+        size_t cardNumber = 0;
+        for (auto card : shareReader.getCards()) {
+          bool binary = shareReader.isBinary();
+          if (!binary || 0 == shareReader.getCardOffset()) {
+            deckCards.push_back(
+                {shareReader.getRecordPos() + shareReader.getCardOffset(),
+                 shareReader.getRecordNum(), cardNumber, binary,
+                 deckFrames.size(), binary ? 0 : card.size()});
+            if (!binary) {
+              deckFrames.append(card.begin(), card.end());
+            }
+          }
+          cardNumber++;
+        }
 
-      std::ostringstream ostream;
-      for (auto &it : header) {
-        ostream << tapeChars->at(it);
+        histogram.fill(0);
+        addToHistogram(histogram, header);
+        addToHistogram(histogram, deckFrames);
+        charsetIndex = detectTapeCharset(histogram, candidates);
       }
-      auto view = ostream.view();
+      auto &tapeCharset = *tapeCharsets[charsetIndex];
+      auto &transcoder = tapeCharset.getTapeTranscoder();
+
+      headerText.clear();
+      transcoder.transcode(header, headerText);
+      std::string_view view = headerText;
 
       // Identification for next library file
       auto classification = view.substr(0, view.find(' ', 0));
@@ -343,45 +428,49 @@ int main(int argc, const char **argv) {
                   << installation << "' Name: '" << name << "' Id: '" << id
                   << "' Format: '" << format << "'"
                   << "\n";
+        if (detectCharset) {
+          std::cout << "Charset: " << tapeCharset.getName() << "\n";
+        }
         std::cout << "===========\n";
       }
 
-      while (true) {
-        auto size = shareReader.read(buffer, sizeof(buffer));
-        if (size == 0) {
-          break;
-        }
-        if (shareReader.isBinary()) {
+      auto showCard = [&](const DeckCard &card, std::span<const char> frames) {
+        if (card.binary) {
           if (showThisDeck) {
-            showPosition(0);
+            showPosition(card);
             std::cout << "Binary\n";
           }
-          cardNumber += size / lineSize;
         } else {
-          std::ostringstream ostream;
-          ShareReader::pos_type linePos = 0;
-          size_t pos = 0;
-
-          for (char *it = &buffer[0]; it < &buffer[size]; ++it) {
-            ostream << tapeChars->at(*it);
-            if (lineSize == ++pos) {
-              auto view = ostream.view();
-              pos = 0;
-              if (view.end() != std::find_if(view.begin(), view.end(),
+          cardText.clear();
+          transcoder.transcode(frames, cardText);
+          if (cardText.end() != std::find_if(cardText.begin(), cardText.end(),
                                              [](char c) { return c != ' '; })) {
-
-                if (showThisDeck) {
-                  showPosition(linePos);
-                  std::cout << view << "\n";
-                }
-              }
-
-              cardNumber++;
-              linePos += lineSize;
-              ostream.str("");
+            if (showThisDeck) {
+              showPosition(card);
+              std::cout << cardText << "\n";
             }
           }
         }
+      };
+
+      if (detectCharset) {
+        for (auto &card : deckCards) {
+          showCard(card, std::span<const char>(deckFrames)
+                             .subspan(card.framesPos, card.framesSize));
+        }
+      } else {
+        // Show each card as it is read
+        size_t cardNumber = 0;
+        for (auto card : shareReader.getCards()) {
+          bool binary = shareReader.isBinary();
+          if (!binary || 0 == shareReader.getCardOffset()) {
+            showCard({shareReader.getRecordPos() + shareReader.getCardOffset(),
+                      shareReader.getRecordNum(), cardNumber, binary, 0,
+                      card.size()},
+                     card);
+          }
+          cardNumber++;
+        }
       }
       if (!shareReader.nextDeck()) {
         return 0;
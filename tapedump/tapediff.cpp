@@ -0,0 +1,154 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compare the records of two P7B tape images
+
+#include "Z0ftware/config.h"
+#include "Z0ftware/p7bistream.hpp"
+#include "Z0ftware/tape.hpp"
+#include "Z0ftware/tapediff.hpp"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+llvm::cl::opt<std::string> leftFileName(llvm::cl::Positional,
+                                        llvm::cl::desc("<Original tape>"),
+                                        llvm::cl::Required);
+
+llvm::cl::opt<std::string> rightFileName(llvm::cl::Positional,
+                                         llvm::cl::desc("<Changed tape>"),
+                                         llvm::cl::Required);
+
+llvm::cl::opt<std::string> editsOutput(
+    "edits-output",
+    llvm::cl::desc("Write record-offsets edits for sharedump --edits"),
+    llvm::cl::value_desc("filename"));
+
+llvm::cl::opt<bool> quiet("quiet",
+                          llvm::cl::desc("Only report number of differences"),
+                          llvm::cl::init(false));
+} // namespace
+
+static std::unique_ptr<TapeRecords> readTape(const std::string &fileName) {
+  std::ifstream input(fileName, std::ifstream::binary | std::ifstream::in);
+  if (!input.is_open()) {
+    throw std::runtime_error("Could not open " + fileName);
+  }
+  IStreamReader iStreamReader(input);
+  P7BIStream p7biStream(iStreamReader);
+  return std::make_unique<TapeRecords>(p7biStream);
+}
+
+int main(int argc, const char **argv) {
+  llvm::cl::SetVersionPrinter([](llvm::raw_ostream &os) {
+    os << "Version " << Z0ftware_VERSION_MAJOR << "." << Z0ftware_VERSION_MINOR
+       << "." << Z0ftware_VERSION_PATCH << "\n";
+  });
+
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Tape record comparison for IBM 704 tapes\n\n"
+      "  This program lists the records that differ between two tapes.\n"
+      "  It exits with 1 if the tapes differ, or 2 if --edits-output\n"
+      "  cannot represent the differences.\n");
+
+  std::unique_ptr<TapeRecords> left;
+  std::unique_ptr<TapeRecords> right;
+  try {
+    auto leftFuture = std::async(std::launch::async, readTape,
+                                 std::string(leftFileName));
+    right = readTape(rightFileName);
+    left = leftFuture.get();
+  } catch (std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  auto &leftRecords = left->getRecords();
+  auto &rightRecords = right->getRecords();
+  auto hunks = diffRecords(*left, *right);
+
+  size_t numChanged = 0;
+  size_t numDeleted = 0;
+  size_t numInserted = 0;
+  json recordOffsets = json::array();
+  for (auto &hunk : hunks) {
+    auto leftSize = hunk.leftEnd - hunk.leftBegin;
+    auto rightSize = hunk.rightEnd - hunk.rightBegin;
+    auto paired = std::min(leftSize, rightSize);
+    for (size_t i = 0; i < paired; ++i) {
+      auto &leftRecord = leftRecords[hunk.leftBegin + i];
+      auto &rightRecord = rightRecords[hunk.rightBegin + i];
+      if (!quiet) {
+        std::cout << "changed " << leftRecord.recordNum << " "
+                  << rightRecord.recordNum << " (" << leftRecord.size << " "
+                  << rightRecord.size << ")\n";
+      }
+      recordOffsets.push_back({leftRecord.recordNum, 0, leftRecord.size,
+                               std::string(right->getData(rightRecord))});
+    }
+    for (auto i = hunk.leftBegin + paired; i < hunk.leftEnd; ++i) {
+      if (!quiet) {
+        std::cout << "deleted " << leftRecords[i].recordNum << " ("
+                  << leftRecords[i].size << ")\n";
+      }
+    }
+    for (auto i = hunk.rightBegin + paired; i < hunk.rightEnd; ++i) {
+      if (!quiet) {
+        std::cout << "inserted " << rightRecords[i].recordNum << " ("
+                  << rightRecords[i].size << ")\n";
+      }
+    }
+    numChanged += paired;
+    numDeleted += leftSize - paired;
+    numInserted += rightSize - paired;
+  }
+  std::cout << numChanged << " changed, " << numDeleted << " deleted, "
+            << numInserted << " inserted\n";
+
+  if (!editsOutput.empty()) {
+    if (numDeleted + numInserted > 0) {
+      // Record-offset edits change the contents of records, not their number
+      // Within a hunk, records are paired by position, so the changed edits
+      // would also be for the wrong records
+      std::cerr << "Deleted and inserted records cannot be written as "
+                   "record-offsets edits, not writing "
+                << editsOutput << "\n";
+      return 2;
+    }
+    std::ofstream os(editsOutput);
+    os << json{{"record-offsets", recordOffsets}}.dump(2) << "\n";
+  }
+
+  return hunks.empty() ? EXIT_SUCCESS : 1;
+}
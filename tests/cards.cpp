@@ -22,10 +22,14 @@
 
 #include "Z0ftware/bcd.hpp"
 #include "Z0ftware/card.hpp"
+#include "Z0ftware/charset.hpp"
 #include "Z0ftware/convert.hpp"
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <sstream>
+
 TEST(cards, bcd) {
   EXPECT_EQ(convert<cpu704_bcd_t>(hollerith()), cpu704_bcd_t(0b110000));
   EXPECT_EQ(convert<cpu704_bcd_t>(hollerith(0)), cpu704_bcd_t(0b000000));
@@ -138,4 +142,177 @@ TEST(cards, writeWords) {
   for (int position = 0; position < 24; position++) {
     EXPECT_EQ(cardImage.getWord(position), position * position);
   }
-}
\ No newline at end of file
+}
+
+TEST(cards, cardDeck) {
+  CardDeck deck("artifacts/obj/cbn/uasap.cbn");
+  ASSERT_EQ(deck.size(), 165);
+  // Columns read from the file's frames by hand
+  EXPECT_EQ(deck[0][1], hollerith_t(0));
+  EXPECT_EQ(deck[0][14], hollerith_t(01));
+  EXPECT_EQ(deck[0][19], hollerith_t(03776));
+  EXPECT_EQ(deck[0][20], hollerith_t(04036));
+  EXPECT_EQ(deck[1][2], hollerith_t(01000));
+  EXPECT_EQ(deck[1][22], hollerith_t(016));
+  EXPECT_EQ(deck[100][1], hollerith_t(040));
+  EXPECT_EQ(deck[100][4], hollerith_t(06276));
+  EXPECT_EQ(deck[164][8], hollerith_t(0101));
+}
+
+TEST(cards, words) {
+  CardImage cardImage;
+  for (int i = 0; i < 80; i++) {
+    cardImage[i + 1] = (i * 2654435761u) >> 7;
+  }
+  auto words = cardImage.getWords();
+  for (int position = 0; position < 24; position++) {
+    EXPECT_EQ(words[position], cardImage.getWord(position))
+        << "Position " << position;
+  }
+
+  CardImage wordImage;
+  for (int position = 0; position < 24; position++) {
+    words[position] = (position * 0x9E3779B97F4A7C15) >> 28;
+    wordImage.setWord(position, words[position]);
+  }
+  cardImage.setWords(words);
+  for (int i = 0; i < 72; i++) {
+    EXPECT_EQ(cardImage[i + 1], wordImage[i + 1]) << "Column " << i;
+  }
+}
+
+TEST(cards, binaryRowColumn) {
+  BinaryColumnCard columnCard;
+  auto &columns = columnCard.getColumns();
+  for (int i = 0; i < 72; i++) {
+    columns[i] = (i * 2654435761u) >> 11;
+  }
+  BinaryRowCard rowCard(columnCard);
+  auto &rowWords = rowCard.getRowWords();
+  EXPECT_EQ(rowWords[0][0], word_t(columns[0].value()) << 24 |
+                                word_t(columns[1].value()) << 12 |
+                                columns[2].value());
+  EXPECT_EQ(rowWords[1][11], word_t(columns[69].value()) << 24 |
+                                 word_t(columns[70].value()) << 12 |
+                                 columns[71].value());
+
+  // Patch a word and punch it again
+  rowCard.getRowWords()[1][0] = 0123456701234;
+  BinaryColumnCard patched(rowCard);
+  EXPECT_EQ(patched.getColumns()[3], hollerith_t(01234));
+  EXPECT_EQ(patched.getColumns()[4], hollerith_t(05670));
+  EXPECT_EQ(patched.getColumns()[5], hollerith_t(01234));
+  for (int i = 6; i < 72; i++) {
+    EXPECT_EQ(patched.getColumns()[i], columns[i]) << "Column " << i;
+  }
+}
+
+TEST(cards, cbn) {
+  CardImage cardImage;
+  for (int i = 0; i < 80; i++) {
+    cardImage[i + 1] = (i * 2654435761u) >> 9;
+  }
+  std::stringstream cbn;
+  writeCBN(cbn, cardImage);
+  EXPECT_EQ(uint8_t(cbn.str()[0]) & 0x80, 0x80);
+  auto readImage = readCBN(cbn);
+  EXPECT_EQ(readImage.getData(), cardImage.getData());
+}
+
+TEST(cards, cardDeckWriter) {
+  std::stringstream cbn;
+  std::stringstream buffered;
+  {
+    CardDeckWriter deckWriter(buffered, 2);
+    CardImage cardImage;
+    for (int card = 0; card < 5; card++) {
+      cardImage.setWord(card, card + 1);
+      writeCBN(cbn, cardImage);
+      deckWriter.write(cardImage);
+    }
+  }
+  EXPECT_EQ(buffered.str(), cbn.str());
+}
+
+TEST(cards, sapDeck) {
+  std::istringstream input("       REM  ONE\n\n" + std::string(85, 'X') +
+                           "\n       END");
+  SAPDeck deck(input);
+  auto &cards = deck.getCards();
+  ASSERT_EQ(cards.size(), 4);
+  EXPECT_EQ(cards[0], "       REM  ONE");
+  EXPECT_EQ(cards[1], "");
+  EXPECT_EQ(cards[2], std::string(85, 'X'));
+  EXPECT_EQ(cards[3], "       END");
+
+  std::ifstream uasap("artifacts/src/uasap.sap");
+  EXPECT_EQ(SAPDeck(uasap).getCards().size(), 3707);
+}
+
+TEST(cards, sourceCards) {
+  auto &charset = *findNamedCharset("sherman");
+  std::string source{"       ORG 256\n"
+                     "START  CLA X+1,4\n"
+                     "       BCD 1(A*B)/C-$=.\n"
+                     "\n"
+                     "       END START\n"};
+  std::istringstream input(source);
+  SAPDeck textDeck(input);
+  std::vector<CardImage> cards;
+  EXPECT_EQ(encodeSourceCards(textDeck.getCards(), charset, cards), 0);
+  ASSERT_EQ(cards.size(), 5);
+  EXPECT_EQ(cards[1][1], hollerith(0, 2));
+  EXPECT_EQ(cards[1][6], hollerith());
+  EXPECT_EQ(cards[1][13], hollerith(12));
+  EXPECT_EQ(cards[1][80], hollerith());
+
+  std::vector<char> text;
+  decodeSourceCards(cards, charset, text);
+  EXPECT_EQ(std::string(text.begin(), text.end()), source);
+
+  // Through a CBN deck
+  std::stringstream cbn;
+  {
+    CardDeckWriter writer(cbn);
+    for (auto &card : cards) {
+      writer.write(card);
+    }
+  }
+  SAPDeck cardDeck(CardDeck(cbn), charset);
+  EXPECT_EQ(cardDeck.getCards(), textDeck.getCards());
+}
+
+TEST(cards, sourceCardsSubstitute) {
+  auto &charset = *findNamedCharset("sherman");
+  std::string_view line{"A      CLA X"};
+  std::vector<CardImage> cards;
+  EXPECT_EQ(encodeSourceCards(std::span(&line, 1), charset, cards), 0);
+  ASSERT_EQ(cards.size(), 1);
+  // 8-5 is unassigned and 0-8-2 is not one byte
+  cards[0][1] = hollerith(8, 5);
+  cards[0][6] = hollerith(0, 8, 2);
+
+  std::vector<char> text;
+  EXPECT_EQ(decodeSourceCards(cards, charset, text), 2);
+  // One byte per column keeps the operation in columns 8-10
+  EXPECT_EQ(std::string(text.begin(), text.end()), "~    ~ CLA X\n");
+}
+
+TEST(cards, sourceCardsUnencodable) {
+  auto &sherman = *findNamedCharset("sherman");
+  std::vector<std::string_view> lines{"       CLA X\r", "       cla x",
+                                      "\tCLA\u00b1"};
+  std::vector<CardImage> cards;
+  // '\r', "cla", 'x' and '\t'; '\u00b1' is in sherman
+  EXPECT_EQ(encodeSourceCards(lines, sherman, cards), 6);
+  ASSERT_EQ(cards.size(), 3);
+  EXPECT_EQ(cards[0][13],
+            hollerith_t(convert_tables::hollerithFromTapeTable[077]));
+
+  // In 029, 077 is '|'
+  cards.clear();
+  std::string_view bar{"|"};
+  EXPECT_EQ(encodeSourceCards(std::span(&bar, 1), *findNamedCharset("029"),
+                              cards),
+            0);
+}
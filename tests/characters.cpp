@@ -24,9 +24,14 @@
 #include "Z0ftware/charset.hpp"
 #include "Z0ftware/convert.hpp"
 #include "Z0ftware/hollerith.hpp"
+#include "Z0ftware/parity.hpp"
+#include "Z0ftware/views.hpp"
 
 #include <gtest/gtest.h>
 
+#include <numeric>
+#include <set>
+
 TEST(characters, hollerith) {
   for (auto &ctp : collateGlyphCardTape.getItems()) {
     EXPECT_EQ(convert<tape_bcd_t>(ctp.hc), ctp.sc) << ctp.collate;
@@ -42,3 +47,250 @@ TEST(characters, tape_bcd) {
         << ctp.collate;
   }
 }
+
+TEST(characters, frames) {
+  for (unsigned i = 0; i < 64; ++i) {
+    EXPECT_EQ(evenFrameTable[i], evenParity(bcd_t(i)).value());
+    EXPECT_EQ(oddFrameTable[i], oddParity(bcd_t(i)).value());
+    EXPECT_EQ(frameDecodeTable[oddFrameTable[i] | 0x80], i | frameOddOk);
+  }
+}
+
+TEST(characters, bulkConvert) {
+  std::vector<tape_bcd_t> tape;
+  std::vector<cpu704_bcd_t> cpu;
+  for (unsigned i = 0; i < 64; ++i) {
+    tape.push_back(tape_bcd_t(i));
+    cpu.push_back(cpu704_bcd_t(i));
+  }
+  std::vector<cpu704_bcd_t> cpuFromTape(tape.size());
+  std::vector<tape_bcd_t> tapeFromCPU(cpu.size());
+  std::vector<hollerith_t> hollerithFromTape(tape.size());
+  std::vector<hollerith_t> hollerithFromCPU(cpu.size());
+  convert(tape, cpuFromTape);
+  convert(cpu, tapeFromCPU);
+  convert(tape, hollerithFromTape);
+  convert(cpu, hollerithFromCPU);
+  for (unsigned i = 0; i < 64; ++i) {
+    EXPECT_EQ(cpuFromTape[i], convert<cpu704_bcd_t>(tape[i]));
+    EXPECT_EQ(tapeFromCPU[i], convert<tape_bcd_t>(cpu[i]));
+    EXPECT_EQ(hollerithFromTape[i], convert<hollerith_t>(tape[i]));
+    EXPECT_EQ(hollerithFromCPU[i], convert<hollerith_t>(cpu[i]));
+  }
+
+  std::vector<hollerith_t> columns;
+  for (unsigned h = 0; h < 1 << 12; ++h) {
+    columns.push_back(hollerith_t(h));
+  }
+  std::vector<tape_bcd_t> tapeFromHollerith(columns.size());
+  std::vector<cpu704_bcd_t> cpuFromHollerith(columns.size());
+  convert(columns, tapeFromHollerith);
+  convert(columns, cpuFromHollerith);
+  for (unsigned h = 0; h < 1 << 12; ++h) {
+    EXPECT_EQ(tapeFromHollerith[h], convert<tape_bcd_t>(columns[h]));
+    EXPECT_EQ(cpuFromHollerith[h], convert<cpu704_bcd_t>(columns[h]));
+  }
+}
+
+TEST(characters, glyphTranscoder) {
+  std::unique_ptr<parity_glyphs_t> glyphs(
+      collateGlyphCardTape.getTapeCharset(false));
+  GlyphTranscoder transcoder(*glyphs);
+  std::string frames;
+  std::string expected;
+  for (char frame = 0; frame < 127; ++frame) {
+    frames += frame;
+    expected += glyphs->at(frame);
+  }
+  std::string output("prefix");
+  transcoder.transcode(frames, output);
+  EXPECT_EQ(output, "prefix" + expected);
+}
+
+TEST(characters, utf8) {
+  char utf8[utf8_max_size];
+  for (unicode_char_t c : {U'A', U'¢', U'⌑', U'⯒', U'\U0001F600'}) {
+    size_t size = encodeUtf8(c, utf8);
+    unicode_char_t decoded;
+    EXPECT_EQ(decodeUtf8(utf8_string_view_t(utf8, size), decoded), size);
+    EXPECT_EQ(decoded, c);
+  }
+  EXPECT_EQ(encodeUtf8(unicode_char_t(0x110000), utf8), 3);
+  EXPECT_EQ(utf8_string_view_t(utf8, 3), utf8_replacement);
+
+  unicode_char_t c;
+  // Overlong, surrogate, truncated
+  for (utf8_string_view_t bad : {"\xC0\x80", "\xED\xA0\x80", "\xE2\x8C"}) {
+    EXPECT_EQ(decodeUtf8(bad, c), 0);
+    EXPECT_EQ(c, unicode_replacement_char);
+  }
+
+  utf8_string_view_t text{"PROGRAM ⌑ WITH √ AND ⯒ PAST EIGHT BYTES\xFF"};
+  unicode_string_t unicode;
+  decodeUtf8(text, unicode);
+  EXPECT_EQ(unicode, U"PROGRAM ⌑ WITH √ AND ⯒ PAST EIGHT BYTES�");
+  utf8_t roundTrip;
+  encodeUtf8(unicode, roundTrip);
+  EXPECT_EQ(roundTrip, "PROGRAM ⌑ WITH √ AND ⯒ PAST EIGHT BYTES�");
+  EXPECT_EQ(bcd("AB"), BCDSherman.getCPUBCD("A").value() << 6 |
+                           BCDSherman.getCPUBCD(U'B').value());
+}
+
+TEST(characters, encodeBCD) {
+  std::initializer_list<const BCDCharSet *> charSets{
+      &BCDIC_A, &BCD704, &BCD716G, &BCDIBM7090, &BCDSherman, &BCDICFinal_B};
+  for (auto charSet : charSets) {
+    utf8_t text;
+    for (int i = 0; i < 64; ++i) {
+      text += (*charSet)[i];
+    }
+    text += "Ω\xFF~";
+    std::vector<bcd_t> bcds(80);
+    size_t count = charSet->encode(text, bcds);
+    utf8_string_view_t sv(text);
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(bcds[i], charSet->getCPUBCD(get_next_unicode_char(sv)))
+          << charSet->getDescription() << " " << i;
+    }
+    EXPECT_TRUE(sv.empty());
+    EXPECT_EQ(charSet->getCPUBCD(U'Ω'), bcd_t(077));
+  }
+  std::array<bcd_t, 2> two;
+  EXPECT_EQ(BCDSherman.encode("ABC", two), 2);
+}
+
+TEST(characters, packBCD) {
+  std::vector<bcd_t> chars;
+  for (unsigned i = 0; i < 64; ++i) {
+    chars.push_back(i);
+  }
+  std::vector<word_t> words(11);
+  EXPECT_EQ(packBCD(chars, words), 11);
+  for (size_t i = 0; i < chars.size(); ++i) {
+    EXPECT_EQ(bcd_t(words[i / 6] >> (30 - 6 * (i % 6))), chars[i]) << i;
+  }
+  EXPECT_EQ(words[10], 0747576776060);
+
+  std::vector<bcd_t> unpacked(66);
+  EXPECT_EQ(unpackBCD(words, unpacked), 66);
+  EXPECT_TRUE(std::equal(chars.begin(), chars.end(), unpacked.begin()));
+  EXPECT_EQ(unpacked[65], bcd_t(060));
+
+  // Both stop at the end of the output
+  EXPECT_EQ(packBCD(chars, std::span(words).first(3)), 3);
+  EXPECT_EQ(unpackBCD(words, std::span(unpacked).first(8)), 8);
+  EXPECT_EQ(unpacked[7], bcd_t(7));
+}
+
+TEST(characters, detectCharset) {
+  std::string frames{"\x01\x41\x3F\x3F\x7F"};
+  bcd_histogram_t histogram{};
+  addToHistogram(histogram, frames);
+  addToHistogram(histogram, frames);
+  EXPECT_EQ(histogram[1], 4);
+  EXPECT_EQ(histogram[077], 6);
+  EXPECT_EQ(std::accumulate(histogram.begin(), histogram.end(), uint64_t(0)),
+            10);
+
+  // Program text written with BCD704 should read back the same with the
+  // detected charset
+  std::unique_ptr<parity_glyphs_t> written =
+      BCDCharSetForTape(BCD704).getTapeCharset(false);
+  std::string text{"      CLA X-1 ALPHA*B/C, $.  "};
+  std::string tape;
+  for (char c : text) {
+    auto it = std::find(written->begin(), written->end(), std::string(1, c));
+    ASSERT_NE(it, written->end()) << c;
+    tape += char(it - written->begin());
+  }
+  std::vector<std::unique_ptr<parity_glyphs_t>> glyphs;
+  glyphs.push_back(BCDCharSetForTape(BCDIC_A).getTapeCharset(false));
+  glyphs.push_back(BCDCharSetForTape(BCD716G).getTapeCharset(false));
+  glyphs.push_back(std::move(written));
+  std::vector<const parity_glyphs_t *> candidates;
+  for (auto &candidate : glyphs) {
+    candidates.push_back(candidate.get());
+  }
+  histogram.fill(0);
+  addToHistogram(histogram, tape);
+  size_t detected = detectTapeCharset(histogram, candidates);
+  std::string output;
+  GlyphTranscoder(*candidates[detected]).transcode(tape, output);
+  EXPECT_EQ(output, text);
+  EXPECT_LT(scoreTapeCharset(histogram, *candidates[0]),
+            scoreTapeCharset(histogram, *candidates[detected]));
+}
+
+TEST(characters, namedCharsets) {
+  EXPECT_EQ(findNamedCharset("no such charset"), nullptr);
+  auto collated = findNamedCharset("collated");
+  ASSERT_NE(collated, nullptr);
+  EXPECT_EQ(&getNamedCharsets().front(), collated);
+  EXPECT_EQ(collated->getTapeGlyphs(),
+            *collateGlyphCardTape.getTapeCharset(true));
+  // Built once
+  EXPECT_EQ(&collated->getTapeGlyphs(), &collated->getTapeGlyphs());
+
+  std::set<std::string> names;
+  for (auto &charset : getNamedCharsets()) {
+    EXPECT_TRUE(names.insert(charset.getName()).second) << charset.getName();
+    // Letters and digits agree everywhere
+    for (char c : std::string_view("AZ09")) {
+      auto column = charset.getHollerith(c);
+      ASSERT_TRUE(column) << charset.getName() << " " << c;
+      EXPECT_EQ(charset.getHollerithGlyph(*column), std::string(1, c))
+          << charset.getName();
+      EXPECT_EQ(charset.getTapeCharSet().getCPUBCD(c),
+                convert<tape_bcd_t>(*column))
+          << charset.getName() << " " << c;
+      EXPECT_EQ(charset.getCPUCharSet().getCPUBCD(c),
+                convert<cpu704_bcd_t>(*column))
+          << charset.getName() << " " << c;
+    }
+  }
+
+  auto sherman = findNamedCharset("sherman");
+  ASSERT_NE(sherman, nullptr);
+  std::array<bcd_t, 6> named;
+  std::array<bcd_t, 6> direct;
+  ASSERT_EQ(sherman->getCPUCharSet().encode("X*Y-1.", named), 6);
+  ASSERT_EQ(BCDSherman.encode("X*Y-1.", direct), 6);
+  EXPECT_EQ(named, direct);
+}
+
+TEST(characters, views) {
+  auto &charset = *findNamedCharset("collated");
+  std::string text{"CLA X+1"};
+  std::string frames;
+  for (char c : text) {
+    frames += evenFrameTable[charset.getTapeCharSet().getCPUBCD(c).value()];
+  }
+  std::span<const char> record(frames);
+
+  std::string output;
+  std::ranges::copy(record | views::glyphs(charset) | std::views::join,
+                    std::back_inserter(output));
+  EXPECT_EQ(output, text);
+
+  std::vector<cpu704_bcd_t> cpu(text.size());
+  std::vector<hollerith_t> columns(text.size());
+  std::ranges::copy(record | views::tape_bcd | views::to_cpu704, cpu.begin());
+  std::ranges::copy(record | views::tape_bcd | views::to_hollerith,
+                    columns.begin());
+  for (size_t i = 0; i < text.size(); ++i) {
+    tape_bcd_t tape = frames[i] & 0x3F;
+    EXPECT_EQ(cpu[i], convert<cpu704_bcd_t>(tape));
+    EXPECT_EQ(columns[i], convert<hollerith_t>(tape));
+  }
+
+  // Any encoding back to glyphs
+  output.clear();
+  std::ranges::copy(columns | views::glyphs(charset) | std::views::join,
+                    std::back_inserter(output));
+  EXPECT_EQ(output, text);
+  output.clear();
+  std::ranges::copy(cpu | views::to_tape_bcd | views::glyphs(charset) |
+                        std::views::join,
+                    std::back_inserter(output));
+  EXPECT_EQ(output, text);
+}
@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/decimal.hpp"
+#include "Z0ftware/word.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+Word parse(std::string_view text) {
+  std::vector<Word> values;
+  EXPECT_TRUE(parseDEC(text, values)) << text;
+  EXPECT_EQ(values.size(), 1) << text;
+  return values.empty() ? Word() : values[0];
+}
+} // namespace
+
+TEST(decimal, fixPoint) {
+  EXPECT_EQ(parse("210"), FixPoint(false, 210));
+  EXPECT_EQ(parse("-5"), FixPoint(true, 5));
+  EXPECT_EQ(parse("+5"), FixPoint(false, 5));
+  EXPECT_EQ(parse("-0"), FixPoint(true, 0));
+  EXPECT_EQ(parse("2B2"), FixPoint(false, 0200000000000));
+  EXPECT_EQ(parse("146B8"), FixPoint(false, 0222000000000));
+  EXPECT_EQ(parse(".5B34"), FixPoint(false, 1));
+  EXPECT_EQ(parse("1.9B35"), FixPoint(false, 1));
+  EXPECT_EQ(parse("-1.9B35"), FixPoint(true, 1));
+  // 0.1 * 2^35 is 3435973836.8
+  EXPECT_EQ(parse(".1B0"), FixPoint(false, 3435973836));
+  EXPECT_EQ(parse("1E2B35"), FixPoint(false, 100));
+  EXPECT_EQ(parse("1B35E2"), FixPoint(false, 100));
+  EXPECT_EQ(parse("34359738367"), FixPoint(false, 0377777777777));
+  EXPECT_EQ(parse("00000000000000000000000000000007"), FixPoint(false, 7));
+}
+
+TEST(decimal, float) {
+  EXPECT_EQ(parse("0.75E0"), FixPoint(false, 0200600000000));
+  EXPECT_EQ(parse("-0.0"), FixPoint(true, 0));
+  EXPECT_EQ(parse("0E99"), Float(false, 0, 0));
+  EXPECT_EQ(parse("0.0E-2147483647"), Float(false, 0, 0));
+  EXPECT_EQ(parse("1."), Float(false, 1, 0400000000));
+  EXPECT_EQ(parse("-2E-1"), Float(true, -2, 0631463146));
+  // 0.1 rounds down, 0.3 rounds up
+  EXPECT_EQ(parse(".1"), Float(false, -3, 0631463146));
+  EXPECT_EQ(parse(".3"), Float(false, -1, 0463146315));
+  // 2^27 + 1 and 2^27 + 3 are ties
+  EXPECT_EQ(parse("134217729."), Float(false, 28, 0400000000));
+  EXPECT_EQ(parse("134217731."), Float(false, 28, 0400000002));
+  // Rounds up to the next power of 2
+  EXPECT_EQ(parse("134217727.5"), Float(false, 28, 0400000000));
+  EXPECT_EQ(parse("1E38"), Float(false, 127, 0454732313));
+  EXPECT_EQ(parse("1.5E-38"), Float(false, -125, 0506527456));
+  EXPECT_EQ(parse("3.14159265358979323846264338327950288419716939937510"),
+            Float(false, 2, 0622077325));
+}
+
+TEST(decimal, errors) {
+  std::vector<Word> values{Word(1)};
+  for (std::string_view text :
+       {"", ".", "-", "1,", ",1", "1E", "1E+", "B2", "1B", "1B123", "1X",
+        "1E5E6", "1B2B3", "1.2.3", "34359738368", "2B1", "1E39", "1E-40",
+        "-1-", "1.25E-2147483647", "1E2147483647"}) {
+    EXPECT_FALSE(parseDEC(text, values)) << text;
+    EXPECT_EQ(values.size(), 1) << text;
+  }
+  // Too many digits to scale exactly
+  for (std::string text :
+       {std::string(5000, '9'), "1." + std::string(5000, '0'),
+        std::string(300, '1') + "." + std::string(300, '1')}) {
+    EXPECT_FALSE(parseDEC(text, values)) << text.size();
+    EXPECT_EQ(values.size(), 1);
+  }
+  EXPECT_TRUE(parseDEC("1,-2.5,3B17 COMMENT, 4", values));
+  EXPECT_EQ(values.size(), 3);
+}
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/editlist.hpp"
+#include "Z0ftware/tapeeditstream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+std::string readAll(Reader &reader) {
+  std::string result;
+  char buffer[4];
+  while (auto size = reader.read(buffer, sizeof(buffer))) {
+    result.append(buffer, size);
+  }
+  return result;
+}
+} // namespace
+
+TEST(editlist, offsets) {
+  auto fileName =
+      (std::filesystem::temp_directory_path() / "Z0ftware_editlist_test.bin")
+          .string();
+  {
+    EditList::Writer writer;
+    writer.addEdit(8, 10, "IJ");
+    writer.addEdit(2, 4, "cd");
+    writer.addEdit(2, 4, "ignored");
+    std::ofstream output(fileName, std::ofstream::binary | std::ofstream::out);
+    writer.write(output);
+  }
+  ASSERT_TRUE(EditList::isEditList(fileName));
+  EditList editList(fileName);
+  ASSERT_EQ(editList.getOffsetEdits().size(), 2);
+  EXPECT_TRUE(editList.getRecordOffsetEdits().empty());
+  EXPECT_EQ(editList.getReplacement(editList.getOffsetEdits()[0]), "cd");
+
+  // Edits from the list are merged with added edits
+  std::istringstream input("abcdefghijkl");
+  IStreamReader iStreamReader(input);
+  ReaderEditor editor(iStreamReader);
+  editor.addEdit(5, 6, "F");
+  editor.addEdits(editList);
+  EXPECT_EQ(readAll(editor), "abcdeFghIJkl");
+  std::filesystem::remove(fileName);
+}
+
+TEST(editlist, badHeader) {
+  auto fileName =
+      (std::filesystem::temp_directory_path() / "Z0ftware_editlist_bad.bin")
+          .string();
+  std::string valid;
+  {
+    EditList::Writer writer;
+    writer.addEdit(2, 4, "cd");
+    writer.addEdit(8, 10, "IJ");
+    std::ostringstream output;
+    writer.write(output);
+    valid = output.str();
+  }
+  auto expectNotEditList = [&fileName](const std::string &contents) {
+    {
+      std::ofstream output(fileName,
+                           std::ofstream::binary | std::ofstream::out);
+      output << contents;
+    }
+    try {
+      EditList editList(fileName);
+      ADD_FAILURE() << "Expected an error";
+    } catch (const std::runtime_error &error) {
+      EXPECT_EQ(std::string(error.what()), fileName + " is not an edit list");
+    }
+  };
+  auto withHeaderField = [&valid](size_t field, uint64_t value) {
+    std::string contents = valid;
+    std::memcpy(&contents[8 + 8 * field], &value, sizeof(value));
+    return contents;
+  };
+  auto withEntryField = [&valid](size_t entry, size_t field, uint64_t value) {
+    std::string contents = valid;
+    std::memcpy(&contents[32 + 40 * entry + 8 * field], &value,
+                sizeof(value));
+    return contents;
+  };
+
+  {
+    std::ofstream output(fileName, std::ofstream::binary | std::ofstream::out);
+    output << valid;
+  }
+  EXPECT_EQ(EditList(fileName).getOffsetEdits().size(), 2);
+  // Truncated header
+  expectNotEditList(valid.substr(0, 16));
+  // Truncated entries
+  expectNotEditList(valid.substr(0, valid.size() - 3));
+  // Entry counts whose byte sizes wrap to 0
+  expectNotEditList(withHeaderField(0, uint64_t(1) << 61));
+  expectNotEditList(withHeaderField(1, uint64_t(1) << 61));
+  // Replacements larger than the file
+  expectNotEditList(withHeaderField(2, ~uint64_t(0)));
+  // Replacement starting past the replacements
+  expectNotEditList(withEntryField(0, 3, 5));
+  // Replacement ending past the replacements
+  expectNotEditList(withEntryField(1, 4, 3));
+  expectNotEditList(withEntryField(1, 4, ~uint64_t(0)));
+  // Entries out of order
+  expectNotEditList(withEntryField(0, 1, 9));
+  std::filesystem::remove(fileName);
+}
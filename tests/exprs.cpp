@@ -44,13 +44,17 @@ private:
   std::unordered_map<std::string, addr_t> map_;
 };
 
-TEST(expr, values) {
+template <typename Parser> class expr : public testing::Test {};
+using Parsers = testing::Types<EXPParser, PegEXPParser>;
+TYPED_TEST_SUITE(expr, Parsers);
+
+TYPED_TEST(expr, values) {
   TestEnvironment env;
   env.setLocation(7);
   env.set("FOUR", 4);
   env.set("FIVE", 5);
 
-  PegEXPParser parser;
+  TypeParam parser;
   std::vector<Expr::ptr> exprs;
   std::string_view comment;
 
@@ -102,3 +106,111 @@ TEST(expr, values) {
   ASSERT_TRUE(parser.parse("X,Y+1,A*A,V", exprs));
   ASSERT_EQ(exprs.size(), 4);
 }
+
+// The PEG parser is the reference for the hand-written parser
+TEST(exprs, reference) {
+  TestEnvironment env;
+  env.setLocation(100);
+  env.set("A", 7);
+  env.set("B", 3);
+  env.set("C", 2);
+  env.set("X", 11);
+  env.set("1A", 13);
+  env.set("A.B", 17);
+
+  EXPParser parser;
+  PegEXPParser pegParser;
+  for (std::string_view text :
+       {"",      "5",      "**",    "*",       "A-B-C", "A/B*C",   "8/2/2",
+        "-",     "+",      ",",     "A+",      "*-1",   "***",     "A**",
+        "**A",   "1A",     "007",   "A.B-1A",  "A,,B",  "--A",     "A+-B",
+        "-A*-B", "X,C+1",  "X COM", "X,A BCD", "a",     "A+(B)",   "A ",
+        " A",    "A*B+C",  "C+A*B", "-*",      "*/*",   "A-B+C-X", "4/A"}) {
+    std::vector<Expr::ptr> exprs;
+    std::vector<Expr::ptr> pegExprs;
+    bool parsed = parser.parse(text, exprs);
+    ASSERT_EQ(parsed, pegParser.parse(text, pegExprs)) << text;
+    if (!parsed) {
+      continue;
+    }
+    ASSERT_EQ(exprs.size(), pegExprs.size()) << text;
+    for (size_t i = 0; i < exprs.size(); ++i) {
+      EXPECT_EQ(exprs[i]->evaluate(env), pegExprs[i]->evaluate(env))
+          << text << " " << i;
+    }
+  }
+
+  // Expressions outlive the parser and many parses
+  std::vector<Expr::ptr> kept;
+  {
+    EXPParser scoped;
+    std::vector<Expr::ptr> exprs;
+    for (int i = 0; i < 10000; ++i) {
+      ASSERT_TRUE(scoped.parse("A+B*C-1A,X", exprs));
+    }
+    kept = exprs;
+  }
+  ASSERT_EQ(kept.size(), 2);
+  EXPECT_EQ(kept[0]->evaluate(env), 7 + 3 * (2 - 13));
+  EXPECT_EQ(kept[1]->evaluate(env), 11);
+}
+
+TEST(exprs, compile) {
+  TestEnvironment env;
+  env.setLocation(100);
+  env.set("A", 7);
+  env.set("B", 3);
+  env.set("X", 11);
+
+  EXPParser parser;
+  SymbolSlots slots;
+  auto compile = [&](std::string_view text) {
+    std::vector<Expr::ptr> exprs;
+    EXPECT_TRUE(parser.parse(text, exprs)) << text;
+    CompiledExpr compiled(*exprs[0], slots);
+    EXPECT_EQ(compiled.evaluate(env), exprs[0]->evaluate(env)) << text;
+    return compiled.getCode().size();
+  };
+  EXPECT_EQ(compile(""), 1);
+  EXPECT_EQ(compile("**"), 1);
+  EXPECT_EQ(compile("2*3+4-1"), 1);
+  EXPECT_EQ(compile("-5"), 1);
+  EXPECT_EQ(compile("A"), 1);
+  EXPECT_EQ(compile("A+1"), 2);
+  EXPECT_EQ(compile("A-2*3"), 2);
+  EXPECT_EQ(compile("*+1"), 2);
+  EXPECT_EQ(compile("*-1"), 2);
+  EXPECT_EQ(compile("A+B"), 3);
+  EXPECT_EQ(compile("1+A"), 3);
+  EXPECT_EQ(compile("-A*B/X+*"), 8);
+  EXPECT_EQ(compile("A-B-X-1"), 6);
+  EXPECT_EQ(compile("A/B*X"), 5);
+  EXPECT_EQ(slots.size(), 3);
+
+  // Deeper than the evaluation stack's inline size
+  std::string deep("A");
+  for (int i = 0; i < 40; ++i) {
+    deep += "+B";
+  }
+  EXPECT_EQ(compile(deep), 81);
+}
+
+TEST(exprs, symbolSlots) {
+  SymbolSlots slots;
+  EXPECT_FALSE(slots.findSlot("A"));
+  std::vector<std::string> names;
+  for (int i = 0; i < 1000; ++i) {
+    names.push_back("S" + std::to_string(i));
+    EXPECT_EQ(slots.getSlot(names.back()), i);
+  }
+  EXPECT_EQ(slots.size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(slots.getSlot(names[i]), i);
+    EXPECT_EQ(slots.findSlot(names[i]), i);
+    EXPECT_EQ(slots.getName(i), names[i]);
+  }
+  EXPECT_FALSE(slots.findSlot("S1000"));
+  EXPECT_FALSE(slots.findSlot(""));
+  EXPECT_EQ(slots.getSlot(""), 1000);
+  EXPECT_EQ(slots.findSlot(""), 1000);
+}
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "Z0ftware/asm.hpp"
+#include "Z0ftware/op.hpp"
 #include "Z0ftware/operation.hpp"
 
 #include <gtest/gtest.h>
@@ -130,3 +131,98 @@ TEST(sap, equ) {
     ASSERT_TRUE(operation->hasErrors());
   }
 }
+
+TEST(sap, extractFields) {
+  std::string sequenced =
+      std::string("A      EQU 1").append(60, ' ') + "SEQ00010";
+  std::vector<std::string_view> lines{"LOOP   CLA X",
+                                      "       REM  This is a comment",
+                                      sequenced};
+  auto fields = SAPAssembler::extractFields(lines);
+  ASSERT_EQ(fields.size(), 3);
+  EXPECT_EQ(fields.locationSymbols[0], "LOOP");
+  EXPECT_EQ(fields.operations[0], "CLA");
+  EXPECT_EQ(fields.variablesAndComments[0], "X");
+  EXPECT_EQ(fields.sequences[0], "");
+  EXPECT_EQ(fields.operations[1], "REM");
+  EXPECT_EQ(fields.locationSymbols[2], "A");
+  EXPECT_EQ(fields.sequences[2], "SEQ00010");
+
+  SAPAssembler sap;
+  auto operation = sap.parseCard(fields, 1);
+  ASSERT_TRUE(operation->on([](Rem &rem) {}));
+  EXPECT_EQ(operation->getComment(), "This is a comment");
+}
+
+TEST(sap, symbols) {
+  SAPAssembler sap;
+  sap.defineSymbol("LOOP", FixPoint(false, 0100));
+  sap.defineSymbol("A", FixPoint(false, 3));
+  sap.defineSymbol("", FixPoint(false, 4));
+  // The first definition is kept
+  sap.defineSymbol("A", FixPoint(false, 5));
+  sap["ZERO"];
+  sap["B"] = FixPoint(false, 6);
+  EXPECT_EQ(sap.getSymbolValue(std::string_view("LOOP")), 0100);
+  EXPECT_EQ(sap.getSymbolValue(std::string_view("A")), 3);
+  EXPECT_EQ(sap.getSymbolValue(std::string_view("ZERO")), 0);
+  EXPECT_EQ(sap.getSymbolValue(std::string_view("B")), 6);
+  EXPECT_THROW((void)sap.getSymbolValue(std::string_view("UNDEF")),
+               std::invalid_argument);
+
+  auto slot = sap.getSymbolSlots().getSlot("LATER");
+  EXPECT_THROW((void)sap.getSymbolValue(slot), std::invalid_argument);
+  sap.defineSymbol("LATER", FixPoint(false, 7));
+  EXPECT_EQ(sap.getSymbolValue(slot), 7);
+
+  auto values = sap.getSortedSymbolValues();
+  ASSERT_EQ(values.size(), 5);
+  EXPECT_EQ(values[0].first, "A");
+  EXPECT_EQ(values[1].first, "B");
+  EXPECT_EQ(values[2].first, "LATER");
+  EXPECT_EQ(values[3].first, "LOOP");
+  EXPECT_EQ(values[4].first, "ZERO");
+  EXPECT_EQ(values[3].second, FixPoint(false, 0100));
+}
+
+TEST(sap, mnemonics) {
+  EXPECT_EQ(mnemonicKey("CLA"), 0234321);
+  EXPECT_EQ(mnemonicKey("TR"), mnemonicKey("TR "));
+  EXPECT_FALSE(mnemonicKey("cla"));
+  EXPECT_FALSE(mnemonicKey("CLAX"));
+  EXPECT_FALSE(mnemonicKey("C*A"));
+
+  auto cla = OpSpec::getOpSpec(std::string_view("CLA"));
+  ASSERT_TRUE(cla);
+  EXPECT_EQ((*cla)->getOperation(), "CLA");
+  EXPECT_EQ((*cla)->getDescription(), "Clear and Add");
+  EXPECT_EQ(OpSpec::getOpSpec(std::string_view("SVN")).value()->getOpCode(),
+            07000);
+  EXPECT_FALSE(OpSpec::getOpSpec(std::string_view("XYZ")));
+  EXPECT_FALSE(OpSpec::getOpSpec(std::string_view("EQU")));
+  EXPECT_FALSE(OpSpec::getOpSpec(std::string_view("")));
+
+  MnemonicTable<int> table{{"ABS", 1}, {"BCD", 2}, {"ABS", 3}};
+  ASSERT_TRUE(table.find("BCD"));
+  EXPECT_EQ(*table.find("BCD"), 2);
+  // Later entries replace earlier ones
+  EXPECT_EQ(*table.find("ABS"), 3);
+  EXPECT_EQ(table.find("ORG"), nullptr);
+  EXPECT_EQ(table.find("abs"), nullptr);
+  EXPECT_THROW(MnemonicTable<int>({{"ABCD", 1}}), std::invalid_argument);
+  EXPECT_THROW(MnemonicTable<int>({{"abs", 1}}), std::invalid_argument);
+
+  // Too many keys for a smaller table, so the identity
+  std::vector<uint32_t> keys{3, 1, 0, 2};
+  auto hash = findPerfectHash(keys, 2);
+  EXPECT_EQ(hash.size(), 4);
+  for (auto key : keys) {
+    EXPECT_EQ(hash(key), key);
+  }
+
+  SAPAssembler sap;
+  auto equ = sap.parseLine("A      EQU  3");
+  EXPECT_TRUE(equ->on([](Equ &) {}));
+  auto cla2 = sap.parseLine("       CLA  A");
+  EXPECT_TRUE(cla2->on([](Instruction &) {}));
+}
@@ -0,0 +1,62 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/p7bistream.hpp"
+#include "Z0ftware/parity.hpp"
+#include "Z0ftware/sharereader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace {
+// A P7B record of count BCD cards of cardSize chars, card i all i
+std::string bcdRecord(size_t cardSize, size_t count) {
+  std::string record;
+  for (size_t i = 0; i < count; ++i) {
+    record.append(cardSize, char(evenParity(bcd_t(i % 64)).value()));
+  }
+  record[0] |= 0x80;
+  return record;
+}
+} // namespace
+
+TEST(sharereader, cards) {
+  // 60 cards of 84 is larger than the record buffer, so some card is split
+  // between buffer fills
+  std::string tape = bcdRecord(84, 1) + bcdRecord(84, 60);
+  std::istringstream input(tape);
+  IStreamReader reader(input);
+  P7BIStream p7bi(reader);
+  ShareReader shareReader(p7bi);
+  EXPECT_EQ(shareReader.getCardSize(), 84);
+  size_t i = 0;
+  for (auto card : shareReader.getCards()) {
+    ASSERT_EQ(card.size(), 84);
+    EXPECT_EQ(shareReader.getCardOffset(), i * 84);
+    auto expected = char(evenParity(bcd_t(i % 64)).value());
+    EXPECT_EQ(card[1], expected);
+    EXPECT_EQ(card[83], expected);
+    ++i;
+  }
+  EXPECT_EQ(i, 60);
+}
@@ -0,0 +1,107 @@
+// MIT License
+//
+// Copyright (c) 2026 Scott Cyphers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Z0ftware/p7bistream.hpp"
+#include "Z0ftware/tapediff.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
+TEST(tapediff, same) {
+  std::vector<uint64_t> left{1, 2, 3, 4};
+  EXPECT_TRUE(diffHashes(left, left).empty());
+}
+
+TEST(tapediff, changed) {
+  auto hunks = diffHashes({1, 2, 3, 4, 5}, {1, 2, 9, 4, 5});
+  ASSERT_EQ(hunks.size(), 1);
+  EXPECT_EQ(hunks[0].leftBegin, 2);
+  EXPECT_EQ(hunks[0].leftEnd, 3);
+  EXPECT_EQ(hunks[0].rightBegin, 2);
+  EXPECT_EQ(hunks[0].rightEnd, 3);
+}
+
+TEST(tapediff, insertedDeleted) {
+  auto hunks = diffHashes({1, 2, 3, 4, 5, 6}, {1, 7, 2, 3, 5, 6});
+  ASSERT_EQ(hunks.size(), 2);
+  // 7 inserted
+  EXPECT_EQ(hunks[0].leftBegin, 1);
+  EXPECT_EQ(hunks[0].leftEnd, 1);
+  EXPECT_EQ(hunks[0].rightBegin, 1);
+  EXPECT_EQ(hunks[0].rightEnd, 2);
+  // 4 deleted
+  EXPECT_EQ(hunks[1].leftBegin, 3);
+  EXPECT_EQ(hunks[1].leftEnd, 4);
+  EXPECT_EQ(hunks[1].rightBegin, 4);
+  EXPECT_EQ(hunks[1].rightEnd, 4);
+}
+
+TEST(tapediff, repeated) {
+  // No unique records, so aligned by LCS
+  auto hunks = diffHashes({1, 2, 1, 2, 1, 2}, {2, 1, 2, 1, 2, 1});
+  size_t leftChanged = 0;
+  size_t rightChanged = 0;
+  for (auto &hunk : hunks) {
+    leftChanged += hunk.leftEnd - hunk.leftBegin;
+    rightChanged += hunk.rightEnd - hunk.rightBegin;
+  }
+  EXPECT_EQ(leftChanged, 1);
+  EXPECT_EQ(rightChanged, 1);
+}
+
+TEST(tapediff, records) {
+  // Three records, the first byte of each has bit 7 set
+  std::string tape("\x81\x02\x03\x84\x05\x86", 6);
+  std::istringstream input(tape);
+  IStreamReader reader(input);
+  P7BIStream p7bi(reader);
+  TapeRecords records(p7bi);
+  ASSERT_EQ(records.getRecords().size(), 3);
+  EXPECT_EQ(records.getData(records.getRecords()[0]), "\x01\x02\x03");
+  EXPECT_EQ(records.getData(records.getRecords()[1]), "\x04\x05");
+  EXPECT_EQ(records.getData(records.getRecords()[2]), "\x06");
+}
+
+TEST(tapediff, diffRecords) {
+  // Records that are all 0 differ by size
+  EXPECT_NE(TapeRecords::hash(""), TapeRecords::hash(std::string(1, '\0')));
+  EXPECT_NE(TapeRecords::hash(std::string(1, '\0')),
+            TapeRecords::hash(std::string(2, '\0')));
+
+  auto readRecords = [](const std::string &tape) {
+    std::istringstream input(tape);
+    IStreamReader reader(input);
+    P7BIStream p7bi(reader);
+    return TapeRecords(p7bi);
+  };
+  auto left = readRecords(std::string("\x81\x02\x83\x84\x05\x86", 6));
+  auto right = readRecords(std::string("\x81\x02\x83\x84\x07\x86", 6));
+  EXPECT_TRUE(diffRecords(left, left).empty());
+  auto hunks = diffRecords(left, right);
+  ASSERT_EQ(hunks.size(), 1);
+  EXPECT_EQ(hunks[0].leftBegin, 2);
+  EXPECT_EQ(hunks[0].leftEnd, 3);
+  EXPECT_EQ(hunks[0].rightBegin, 2);
+  EXPECT_EQ(hunks[0].rightEnd, 3);
+}